@@ -0,0 +1,143 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include "Building.h"
+#include "DispatchStrategy.h"
+#include "TrafficGenerator.h"
+
+// Counts heap allocations made while a building simulates, to check that
+// the simulation itself allocates nothing per event, call or passenger.
+// Every scenario first runs on a new building, during which the event
+// heap, waiting queues, passenger slots and scratch buffers grow to their
+// working size. The building is then reset and runs the same traffic
+// again while every call to operator new is counted. The working set is
+// then exactly what the first run grew into, so any allocation is one the
+// simulation makes as it goes. (Traffic under another seed can still grow
+// a queue or the passenger slots once, past the first run's peak.) Exits
+// with status 1 if any scenario allocated on the reused building.
+
+namespace {
+
+std::atomic<long> allocations(0);
+bool counting = false;
+
+void* allocate(std::size_t size) {
+    if (counting) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    void* block = std::malloc(size ? size : 1);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+struct Case {
+    const char* name;
+    const char* strategy;
+    TrafficGenerator::Pattern pattern;
+    int numFloors;
+    int numElevators;
+    double passengersPerHour;
+    double batchWindow; // Seconds; 0 uses hall calls
+};
+
+const double RUN_HOURS = 6.0;
+const std::uint64_t SEED = 1;
+
+const Case CASES[] = {
+    {"interfloor/nearest", "nearest", TrafficGenerator::INTERFLOOR, 20, 4, 300.0, 0.0},
+    {"interfloor/collective", "collective", TrafficGenerator::INTERFLOOR, 20, 4, 300.0, 0.0},
+    {"up-peak/eta", "eta", TrafficGenerator::UP_PEAK, 30, 6, 900.0, 0.0},
+    {"lunch/fast-eta", "fast-eta", TrafficGenerator::LUNCH, 50, 16, 2000.0, 0.0},
+    {"down-peak/zoning", "zoning", TrafficGenerator::DOWN_PEAK, 40, 8, 1200.0, 0.0},
+    {"up-peak/eta/destination", "eta", TrafficGenerator::UP_PEAK, 30, 6, 900.0, 2.0},
+};
+
+void simulate(Building& building, TrafficGenerator& traffic, double hours) {
+    traffic.run(building, SimClock::fromSeconds(hours * 3600.0));
+    while (building.step()) {
+    }
+}
+
+struct Counts {
+    long firstRun;
+    long reusedRun;
+};
+
+Counts measure(const Case& scenario) {
+    Counts counts;
+    TrafficGenerator firstRun(scenario.numFloors, scenario.passengersPerHour, SEED);
+    TrafficGenerator reusedRun(scenario.numFloors, scenario.passengersPerHour, SEED);
+    firstRun.setPattern(scenario.pattern);
+    reusedRun.setPattern(scenario.pattern);
+    Building building(scenario.numFloors, scenario.numElevators, 12);
+    building.setDispatchStrategy(DispatchStrategy::create(scenario.strategy));
+    building.setDestinationDispatch(SimClock::fromSeconds(scenario.batchWindow));
+    
+    long before = allocations.load();
+    counting = true;
+    simulate(building, firstRun, RUN_HOURS);
+    counting = false;
+    counts.firstRun = allocations.load() - before;
+    
+    building.reset();
+    before = allocations.load();
+    counting = true;
+    simulate(building, reusedRun, RUN_HOURS);
+    counting = false;
+    counts.reusedRun = allocations.load() - before;
+    return counts;
+}
+
+}
+
+void* operator new(std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return allocate(size);
+}
+
+void operator delete(void* block) noexcept {
+    std::free(block);
+}
+
+void operator delete[](void* block) noexcept {
+    std::free(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept {
+    std::free(block);
+}
+
+void operator delete[](void* block, std::size_t) noexcept {
+    std::free(block);
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            std::cout << "Usage: " << argv[0] << std::endl;
+            std::cout << "Counts heap allocations while several scenarios run on a reset building;" << std::endl;
+            std::cout << "exits with status 1 if any scenario allocated" << std::endl;
+            return 0;
+        }
+    }
+    
+    bool clean = true;
+    for (const Case& scenario : CASES) {
+        Counts counts = measure(scenario);
+        std::cout << scenario.name << ": " << counts.firstRun << " allocations in " << RUN_HOURS
+                  << " simulated hours on a new building, " << counts.reusedRun << " after reset" << std::endl;
+        clean = clean && counts.reusedRun == 0;
+    }
+    std::cout << (clean ? "Reused buildings are allocation-free" : "Reused buildings allocate") << std::endl;
+    return clean ? 0 : 1;
+}
@@ -0,0 +1,391 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Building.h"
+#include "DispatchKernel.h"
+#include "DispatchStrategy.h"
+#include "EventTrace.h"
+#include "TrafficGenerator.h"
+
+// Benchmark suite for the simulation core. Micro benchmarks time single
+// operations (adding a stop, handling an event, choosing a car, advancing a
+// frame) on a warmed-up building; macro benchmarks run whole scenarios and
+// report simulated seconds per wall-clock second. Results can be written
+// as JSON and compared against an earlier run to catch regressions.
+
+namespace {
+
+const int FLOOR_COUNTS[] = {10, 50, 200};
+const int ELEVATOR_COUNTS[] = {4, 16, 64};
+const int PASSENGERS_PER_CAR_PER_HOUR = 150;
+const int CAPACITY = 20;
+const int REPETITIONS = 3;
+const std::uint64_t SEED = 1;
+
+typedef std::chrono::steady_clock BenchClock;
+
+double elapsedSeconds(BenchClock::time_point start) {
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+struct Result {
+    std::string name;
+    double value;
+    std::string unit;
+    bool higherIsBetter;
+};
+
+// Runs a timed body with a growing iteration count until one batch takes
+// at least minSeconds, then reports the median time per iteration over a
+// few repetitions. The body returns the seconds it spent on the timed part
+// so that per-batch setup can be left out.
+class Harness {
+public:
+    Harness(double minSeconds, const std::string& filter) : minSeconds(minSeconds), filter(filter) {}
+    
+    bool enabled(const std::string& name) const {
+        return filter.empty() || name.find(filter) != std::string::npos;
+    }
+    
+    void measure(const std::string& name, const std::function<double(long)>& body) {
+        if (!enabled(name)) {
+            return;
+        }
+        
+        // Grow the batch in proportion to how far short of minSeconds the
+        // last one fell, as setup outside the timed part can be costly
+        long iterations = 1;
+        double seconds = body(iterations);
+        while (seconds < minSeconds && iterations < (1L << 30)) {
+            double scale = (seconds > 0.0) ? 1.4 * minSeconds / seconds : 10.0;
+            iterations = static_cast<long>(iterations * std::max(2.0, std::min(scale, 10.0)));
+            seconds = body(iterations);
+        }
+        
+        std::vector<double> samples;
+        for (int i = 0; i < REPETITIONS; i++) {
+            samples.push_back(body(iterations) * 1e9 / iterations);
+        }
+        std::sort(samples.begin(), samples.end());
+        record({name, samples[samples.size() / 2], "ns/op", false});
+    }
+    
+    void record(const Result& result) {
+        results.push_back(result);
+        std::cout << std::left << std::setw(52) << result.name << std::right
+                  << std::setw(14) << result.value << " " << result.unit << std::endl;
+    }
+    
+    const std::vector<Result>& getResults() const {
+        return results;
+    }
+    
+private:
+    double minSeconds;
+    std::string filter;
+    std::vector<Result> results;
+};
+
+std::string scenarioName(const char* benchmark, int numFloors, int numElevators) {
+    std::ostringstream name;
+    name << benchmark << "/" << numFloors << "x" << numElevators;
+    return name.str();
+}
+
+// A building with an hour of interfloor traffic queued, advanced half way
+// so cars are loaded and moving
+std::unique_ptr<Building> makeLoadedBuilding(int numFloors, int numElevators, const std::string& strategy) {
+    std::unique_ptr<Building> building(new Building(numFloors, numElevators, CAPACITY));
+    building->setDispatchStrategy(DispatchStrategy::create(strategy));
+    
+    TrafficGenerator traffic(numFloors, PASSENGERS_PER_CAR_PER_HOUR * numElevators, SEED);
+    for (TrafficGenerator::Trip trip = traffic.next(); trip.time < SimClock::fromSeconds(3600.0);
+         trip = traffic.next()) {
+        building->schedulePassenger(trip.time, trip.origin, trip.destination);
+    }
+    building->runUntil(SimClock::fromSeconds(1800.0));
+    return building;
+}
+
+void runCarBenchmarks(Harness& harness, int numFloors) {
+    // Queue every floor as a stop on a moving car; the car is recreated
+    // for each batch so most calls take the insert path. Only the car's
+    // own state is touched, so this runs once per floor count on a
+    // one-car building to keep the setup cheap.
+    harness.measure(scenarioName("Elevator::addRequest", numFloors, 1), [=](long iterations) {
+        double seconds = 0.0;
+        long done = 0;
+        while (done < iterations) {
+            Building building(numFloors, 1, CAPACITY);
+            building.addCarCall(0, numFloors);
+            long batch = std::min<long>(iterations - done, numFloors - 1);
+            
+            auto start = BenchClock::now();
+            for (long i = 0; i < batch; i++) {
+                building.addCarCall(0, 1 + static_cast<int>(i));
+            }
+            seconds += elapsedSeconds(start);
+            done += batch;
+        }
+        return seconds;
+    });
+}
+
+void runMicroBenchmarks(Harness& harness, int numFloors, int numElevators) {
+    // The model is event driven, so a car's update is one handled event
+    harness.measure(scenarioName("Elevator::handleEvent", numFloors, numElevators), [=](long iterations) {
+        double seconds = 0.0;
+        long done = 0;
+        while (done < iterations) {
+            std::unique_ptr<Building> building = makeLoadedBuilding(numFloors, numElevators, "eta");
+            
+            auto start = BenchClock::now();
+            while (done < iterations && building->step()) {
+                done++;
+            }
+            seconds += elapsedSeconds(start);
+        }
+        return seconds;
+    });
+    
+    const char* strategies[] = {"eta", "fast-eta"};
+    for (const char* strategyName : strategies) {
+        std::string name = scenarioName("Building::findBestElevator", numFloors, numElevators) + "/" + strategyName;
+        if (!harness.enabled(name)) {
+            continue;
+        }
+        
+        std::unique_ptr<Building> building = makeLoadedBuilding(numFloors, numElevators, strategyName);
+        harness.measure(name, [&building, numFloors](long iterations) {
+            const DispatchStrategy& strategy = building->getDispatchStrategy();
+            std::vector<float> scratch(building->getNumElevators());
+            volatile int sink = 0;
+            auto start = BenchClock::now();
+            for (long i = 0; i < iterations; i++) {
+                Request request(1 + static_cast<int>(i % numFloors), (i & 1) ? Request::UP : Request::DOWN);
+                sink = strategy.selectElevator(request, building->getElevators(), building->getFleet(),
+                                               building->getFloors(), building->getClock().now(), scratch.data());
+            }
+            (void)sink;
+            return elapsedSeconds(start);
+        });
+    }
+    
+    // One 60 Hz frame of the graphical front end; the building is replaced
+    // every ten simulated minutes so the cars stay busy
+    harness.measure(scenarioName("Building::update", numFloors, numElevators), [=](long iterations) {
+        const long framesPerBuilding = 60 * 600;
+        double seconds = 0.0;
+        long done = 0;
+        while (done < iterations) {
+            std::unique_ptr<Building> building = makeLoadedBuilding(numFloors, numElevators, "eta");
+            long batch = std::min(iterations - done, framesPerBuilding);
+            
+            auto start = BenchClock::now();
+            for (long i = 0; i < batch; i++) {
+                building->update(1.0 / 60.0);
+            }
+            seconds += elapsedSeconds(start);
+            done += batch;
+        }
+        return seconds;
+    });
+}
+
+void runTraceBenchmark(Harness& harness) {
+    // One recorded event with tracing switched on; compiled-out builds
+    // have nothing to time. A cache-sized ring keeps this about recording
+    // rather than memory bandwidth.
+    if (!EventTrace::isCompiledIn()) {
+        return;
+    }
+    EventTrace::setCapacity(1 << 16);
+    harness.measure("EventTrace::record", [](long iterations) {
+        EventTrace::clear();
+        EventTrace::setEnabled(true);
+        auto start = BenchClock::now();
+        for (long i = 0; i < iterations; i++) {
+            TRACE_EVENT(i, EventTrace::CAR_ARRIVED, static_cast<int>(i & 7), static_cast<int>(i & 31));
+        }
+        double seconds = elapsedSeconds(start);
+        EventTrace::setEnabled(false);
+        return seconds;
+    });
+}
+
+void runMacroBenchmark(Harness& harness, int numFloors, int numElevators) {
+    std::string name = scenarioName("Scenario", numFloors, numElevators);
+    if (!harness.enabled(name)) {
+        return;
+    }
+    
+    // One hour of traffic run to completion
+    std::vector<double> speeds;
+    for (int i = 0; i < REPETITIONS; i++) {
+        Building building(numFloors, numElevators, CAPACITY);
+        building.setDispatchStrategy(DispatchStrategy::create("eta"));
+        TrafficGenerator traffic(numFloors, PASSENGERS_PER_CAR_PER_HOUR * numElevators, SEED + i);
+        
+        auto start = BenchClock::now();
+        traffic.run(building, SimClock::fromSeconds(3600.0));
+        while (building.step()) {
+        }
+        speeds.push_back(building.getClock().nowSeconds() / elapsedSeconds(start));
+    }
+    std::sort(speeds.begin(), speeds.end());
+    harness.record({name, speeds[speeds.size() / 2], "sim-s/wall-s", true});
+}
+
+void writeJson(const std::string& path, const std::vector<Result>& results) {
+    std::ofstream file(path);
+    if (!file) {
+        throw std::runtime_error("Could not write benchmark results: " + path);
+    }
+    
+    // One benchmark per line keeps the file easy to diff
+    file << "{\n  \"simd\": " << (DispatchKernel::hasSimd() ? "true" : "false") << ",\n";
+    file << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        file << "    {\"name\": \"" << results[i].name << "\", \"value\": "
+             << std::setprecision(6) << results[i].value
+             << ", \"unit\": \"" << results[i].unit << "\", \"higher_is_better\": "
+             << (results[i].higherIsBetter ? "true" : "false") << "}"
+             << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+}
+
+// Reads the name and value of each benchmark line written by writeJson
+std::map<std::string, double> readJson(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Could not read benchmark results: " + path);
+    }
+    
+    std::map<std::string, double> values;
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t name = line.find("\"name\": \"");
+        size_t value = line.find("\"value\": ");
+        if (name == std::string::npos || value == std::string::npos) {
+            continue;
+        }
+        name += 9;
+        values[line.substr(name, line.find('"', name) - name)] = std::atof(line.c_str() + value + 9);
+    }
+    return values;
+}
+
+// Prints the change of every benchmark against a baseline; returns the
+// number that got worse by more than the threshold
+int compare(const std::vector<Result>& results, const std::map<std::string, double>& baseline,
+            double thresholdPercent) {
+    int regressions = 0;
+    std::cout << std::endl << "Change against baseline (threshold " << thresholdPercent << "%):" << std::endl;
+    for (const auto& result : results) {
+        auto previous = baseline.find(result.name);
+        if (previous == baseline.end() || previous->second <= 0.0) {
+            continue;
+        }
+        
+        double change = (result.value - previous->second) / previous->second * 100.0;
+        double worse = result.higherIsBetter ? -change : change;
+        bool regressed = worse > thresholdPercent;
+        regressions += regressed;
+        std::cout << std::left << std::setw(52) << result.name << std::right
+                  << std::setw(9) << std::showpos << change << std::noshowpos << "%"
+                  << (regressed ? "  REGRESSION" : "") << std::endl;
+    }
+    return regressions;
+}
+
+void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " [options]" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --json <file>          Write results as JSON" << std::endl;
+    std::cout << "  --compare <file>       Compare against an earlier JSON result; exits 2 on regression" << std::endl;
+    std::cout << "  --threshold <percent>  Allowed slowdown before a change counts as a regression (default: 10)" << std::endl;
+    std::cout << "  --filter <text>        Only run benchmarks whose name contains the text" << std::endl;
+    std::cout << "  --min-time <sec>       Minimum time per measured batch (default: 0.1)" << std::endl;
+    std::cout << "  -h, --help             Display this help message" << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        std::string jsonPath;
+        std::string baselinePath;
+        std::string filter;
+        double thresholdPercent = 10.0;
+        double minSeconds = 0.1;
+        
+        for (int i = 1; i < argc; i++) {
+            bool hasValue = i + 1 < argc;
+            if (strcmp(argv[i], "--json") == 0 && hasValue) {
+                jsonPath = argv[++i];
+            } else if (strcmp(argv[i], "--compare") == 0 && hasValue) {
+                baselinePath = argv[++i];
+            } else if (strcmp(argv[i], "--threshold") == 0 && hasValue) {
+                thresholdPercent = std::stod(argv[++i]);
+            } else if (strcmp(argv[i], "--filter") == 0 && hasValue) {
+                filter = argv[++i];
+            } else if (strcmp(argv[i], "--min-time") == 0 && hasValue) {
+                minSeconds = std::stod(argv[++i]);
+            } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+                printUsage(argv[0]);
+                return 0;
+            } else {
+                std::cerr << "Unknown option: " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        
+        // Read the baseline first so a bad path fails before the long run
+        std::map<std::string, double> baseline;
+        if (!baselinePath.empty()) {
+            baseline = readJson(baselinePath);
+        }
+        
+        Harness harness(minSeconds, filter);
+        std::cout << std::fixed << std::setprecision(1);
+        runTraceBenchmark(harness);
+        for (int numFloors : FLOOR_COUNTS) {
+            runCarBenchmarks(harness, numFloors);
+            for (int numElevators : ELEVATOR_COUNTS) {
+                runMicroBenchmarks(harness, numFloors, numElevators);
+            }
+        }
+        for (int numFloors : FLOOR_COUNTS) {
+            for (int numElevators : ELEVATOR_COUNTS) {
+                runMacroBenchmark(harness, numFloors, numElevators);
+            }
+        }
+        
+        if (!jsonPath.empty()) {
+            writeJson(jsonPath, harness.getResults());
+        }
+        if (!baselinePath.empty() && compare(harness.getResults(), baseline, thresholdPercent) > 0) {
+            return 2;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
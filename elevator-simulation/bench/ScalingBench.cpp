@@ -0,0 +1,120 @@
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Building.h"
+#include "DispatchStrategy.h"
+
+// Scaling benchmark: runs one simulated hour for a grid of building sizes
+// and reports the wall-clock cost per event and per dispatch decision. The
+// passenger rate grows with the number of cars so every car sees the same
+// load; per-event cost should then stay flat as floors grow and grow at
+// most linearly with cars (dispatch scans the fleet once per call).
+
+namespace {
+
+const int FLOOR_COUNTS[] = {10, 50, 100, 200};
+const int ELEVATOR_COUNTS[] = {4, 16, 32, 64};
+const int PASSENGERS_PER_CAR_PER_HOUR = 150;
+const int CAPACITY = 20;
+const int DISPATCH_SAMPLES = 200000;
+
+double elapsedSeconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void runScenario(int numFloors, int numElevators, const std::string& strategyName, unsigned int seed) {
+    Building building(numFloors, numElevators, CAPACITY);
+    building.setDispatchStrategy(DispatchStrategy::create(strategyName));
+    
+    // Uniform random trips over one hour
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> arrivalDist(0.0, 3600.0);
+    std::uniform_int_distribution<int> floorDist(1, numFloors);
+    int numPassengers = PASSENGERS_PER_CAR_PER_HOUR * numElevators;
+    for (int i = 0; i < numPassengers; i++) {
+        int origin = floorDist(rng);
+        int destination = floorDist(rng);
+        while (destination == origin) {
+            destination = floorDist(rng);
+        }
+        building.schedulePassenger(SimClock::fromSeconds(arrivalDist(rng)), origin, destination);
+    }
+    
+    // Run the first half hour to warm the fleet up, then sample dispatch
+    // decisions against the loaded cars
+    building.runUntil(SimClock::fromSeconds(1800.0));
+    
+    const DispatchStrategy& strategy = building.getDispatchStrategy();
+    std::vector<float> scratch(building.getNumElevators());
+    auto dispatchStart = std::chrono::steady_clock::now();
+    int checksum = 0;
+    for (int i = 0; i < DISPATCH_SAMPLES; i++) {
+        int floor = 1 + i % numFloors;
+        Request request(floor, (i & 1) ? Request::UP : Request::DOWN);
+        checksum += strategy.selectElevator(request, building.getElevators(), building.getFleet(),
+                                            building.getFloors(), building.getClock().now(), scratch.data());
+    }
+    double dispatchSeconds = elapsedSeconds(dispatchStart);
+    
+    // Time the remaining events
+    auto runStart = std::chrono::steady_clock::now();
+    long numEvents = 0;
+    while (building.step()) {
+        numEvents++;
+    }
+    double runSeconds = elapsedSeconds(runStart);
+    
+    std::cout << std::setw(7) << numFloors
+              << std::setw(6) << numElevators
+              << std::setw(10) << numPassengers
+              << std::setw(10) << numEvents
+              << std::setw(12) << (numEvents ? runSeconds * 1e9 / numEvents : 0.0)
+              << std::setw(14) << dispatchSeconds * 1e9 / DISPATCH_SAMPLES
+              << std::setw(12) << (dispatchSeconds * 1e9 / DISPATCH_SAMPLES) / numElevators
+              << std::setw(10) << (checksum & 0xff) // Keeps the dispatch loop from being optimised away
+              << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string strategyName = "eta";
+    unsigned int seed = 1;
+    
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if ((strcmp(argv[i], "-a") == 0 || strcmp(argv[i], "--strategy") == 0) && hasValue) {
+            strategyName = argv[++i];
+        } else if ((strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--seed") == 0) && hasValue) {
+            seed = static_cast<unsigned int>(std::stoul(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [-a strategy] [-s seed]" << std::endl;
+            return 1;
+        }
+    }
+    
+    if (!DispatchStrategy::create(strategyName)) {
+        std::cerr << "Unknown dispatch strategy: " << strategyName << std::endl;
+        return 1;
+    }
+    
+    std::cout << "Strategy: " << strategyName << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::setw(7) << "floors" << std::setw(6) << "cars" << std::setw(10) << "trips"
+              << std::setw(10) << "events" << std::setw(12) << "ns/event" << std::setw(14) << "ns/dispatch"
+              << std::setw(12) << "ns/car" << std::setw(10) << "check" << std::endl;
+    
+    for (int numFloors : FLOOR_COUNTS) {
+        for (int numElevators : ELEVATOR_COUNTS) {
+            runScenario(numFloors, numElevators, strategyName, seed);
+        }
+    }
+    
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include "BinaryStream.h"
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+void encode(unsigned char* data, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        data[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+std::uint64_t decode(const unsigned char* data, int bytes) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= static_cast<std::uint64_t>(data[i]) << (8 * i);
+    }
+    return value;
+}
+}
+
+BinaryWriter::BinaryWriter(std::ostream& out) : out(out) {
+}
+
+void BinaryWriter::writeUInt8(std::uint8_t value) {
+    out.put(static_cast<char>(value));
+}
+
+void BinaryWriter::writeUInt32(std::uint32_t value) {
+    unsigned char data[4];
+    encode(data, value, 4);
+    writeBytes(data, 4);
+}
+
+void BinaryWriter::writeUInt64(std::uint64_t value) {
+    unsigned char data[8];
+    encode(data, value, 8);
+    writeBytes(data, 8);
+}
+
+void BinaryWriter::writeInt(int value) {
+    writeUInt32(static_cast<std::uint32_t>(value));
+}
+
+void BinaryWriter::writeInt64(std::int64_t value) {
+    writeUInt64(static_cast<std::uint64_t>(value));
+}
+
+void BinaryWriter::writeDouble(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeUInt64(bits);
+}
+
+void BinaryWriter::writeBool(bool value) {
+    writeUInt8(value ? 1 : 0);
+}
+
+void BinaryWriter::writeString(const std::string& value) {
+    writeUInt64(value.size());
+    writeBytes(value.data(), value.size());
+}
+
+void BinaryWriter::writeBytes(const void* data, size_t size) {
+    out.write(static_cast<const char*>(data), size);
+    if (!out) {
+        throw std::runtime_error("Failed to write snapshot");
+    }
+}
+
+BinaryReader::BinaryReader(std::istream& in) : in(in) {
+}
+
+std::uint8_t BinaryReader::readUInt8() {
+    unsigned char value;
+    readBytes(&value, 1);
+    return value;
+}
+
+std::uint32_t BinaryReader::readUInt32() {
+    unsigned char data[4];
+    readBytes(data, 4);
+    return static_cast<std::uint32_t>(decode(data, 4));
+}
+
+std::uint64_t BinaryReader::readUInt64() {
+    unsigned char data[8];
+    readBytes(data, 8);
+    return decode(data, 8);
+}
+
+int BinaryReader::readInt() {
+    return static_cast<std::int32_t>(readUInt32());
+}
+
+std::int64_t BinaryReader::readInt64() {
+    return static_cast<std::int64_t>(readUInt64());
+}
+
+double BinaryReader::readDouble() {
+    std::uint64_t bits = readUInt64();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool BinaryReader::readBool() {
+    return readUInt8() != 0;
+}
+
+std::string BinaryReader::readString() {
+    std::string value(readCount(1 << 24), '\0');
+    readBytes(&value[0], value.size());
+    return value;
+}
+
+void BinaryReader::readBytes(void* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    in.read(static_cast<char*>(data), size);
+    if (in.gcount() != static_cast<std::streamsize>(size)) {
+        throw std::runtime_error("Snapshot is truncated");
+    }
+}
+
+size_t BinaryReader::readCount(size_t limit) {
+    std::uint64_t count = readUInt64();
+    if (count > limit) {
+        throw std::runtime_error("Snapshot is corrupt: count " + std::to_string(count) +
+                                 " exceeds " + std::to_string(limit));
+    }
+    return count;
+}
@@ -0,0 +1,53 @@
+#ifndef BINARYSTREAM_H
+#define BINARYSTREAM_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Fixed-width little-endian encoding for checkpoint files, so a snapshot
+// written on one machine restores on any other. Doubles are stored as
+// their IEEE-754 bit pattern and round-trip exactly.
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::ostream& out);
+    
+    void writeUInt8(std::uint8_t value);
+    void writeUInt32(std::uint32_t value);
+    void writeUInt64(std::uint64_t value);
+    void writeInt(int value);
+    void writeInt64(std::int64_t value);
+    void writeDouble(double value);
+    void writeBool(bool value);
+    void writeString(const std::string& value);
+    void writeBytes(const void* data, size_t size);
+    
+private:
+    std::ostream& out;
+};
+
+// Reads what BinaryWriter wrote; throws std::runtime_error if the stream
+// ends early
+class BinaryReader {
+public:
+    explicit BinaryReader(std::istream& in);
+    
+    std::uint8_t readUInt8();
+    std::uint32_t readUInt32();
+    std::uint64_t readUInt64();
+    int readInt();
+    std::int64_t readInt64();
+    double readDouble();
+    bool readBool();
+    std::string readString();
+    void readBytes(void* data, size_t size);
+    
+    // Element count that must fit in [0, limit]; guards allocations
+    // against corrupt files
+    size_t readCount(size_t limit);
+    
+private:
+    std::istream& in;
+};
+
+#endif // BINARYSTREAM_H
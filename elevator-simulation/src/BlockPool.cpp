@@ -0,0 +1,31 @@
+#include "BlockPool.h"
+#include <stdexcept>
+
+BlockPool::BlockPool() : freeBlocks(MAX_SIZE_CLASS + 1) {
+}
+
+int* BlockPool::acquire(int sizeClass) {
+    if (sizeClass < 0 || sizeClass > MAX_SIZE_CLASS) {
+        throw std::length_error("Pool block size out of range");
+    }
+    
+    std::vector<int*>& free = freeBlocks[sizeClass];
+    if (!free.empty()) {
+        int* block = free.back();
+        free.pop_back();
+        return block;
+    }
+    
+    blocks.emplace_back(new int[size_t(1) << sizeClass]);
+    return blocks.back().get();
+}
+
+void BlockPool::release(int* block, int sizeClass) {
+    if (block) {
+        freeBlocks[sizeClass].push_back(block);
+    }
+}
+
+size_t BlockPool::getBlocksAllocated() const {
+    return blocks.size();
+}
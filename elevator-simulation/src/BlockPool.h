@@ -0,0 +1,34 @@
+#ifndef BLOCKPOOL_H
+#define BLOCKPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Free lists of int blocks in power-of-two sizes, shared by the queues of
+// one building. A queue that outgrows its block hands it back, and the
+// next queue that needs a block of that size takes it, so once every
+// queue has reached its working size no queue operation allocates. Blocks
+// live as long as the pool.
+class BlockPool {
+public:
+    static const int MAX_SIZE_CLASS = 30; // Blocks of up to 2^30 ints
+    
+    BlockPool();
+    
+    // Queues hold pointers into the pool, so it cannot be copied
+    BlockPool(const BlockPool&) = delete;
+    BlockPool& operator=(const BlockPool&) = delete;
+    
+    // A block of 2^sizeClass ints, recycled if one is free
+    int* acquire(int sizeClass);
+    void release(int* block, int sizeClass);
+    
+    size_t getBlocksAllocated() const;
+    
+private:
+    std::vector<std::unique_ptr<int[]>> blocks; // Every block ever allocated
+    std::vector<std::vector<int*>> freeBlocks;  // Per size class
+};
+
+#endif // BLOCKPOOL_H
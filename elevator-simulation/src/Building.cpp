@@ -1,39 +1,415 @@
 #include "Building.h"
 #include "Elevator.h"
+#include "EventTrace.h"
 #include "Floor.h"
+#include "NearestCarStrategy.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 #include <cmath>
 
-Building::Building(int numFloors, int numElevators) 
-    : numFloors(numFloors) {
+Building::Building(int numFloors, int numElevators, int elevatorCapacity) 
+    : numFloors(numFloors), elevatorCapacity(elevatorCapacity), eventsProcessed(0), fleet(numFloors),
+      dispatcher(new NearestCarStrategy()), passengersServed(0), sampler(nullptr), nextSample(0) {
+    
+    if (numFloors < MIN_FLOORS || numFloors > MAX_FLOORS) {
+        throw std::invalid_argument("Number of floors must be between " + std::to_string(MIN_FLOORS) +
+                                    " and " + std::to_string(MAX_FLOORS));
+    }
+    if (numElevators < MIN_ELEVATORS || numElevators > MAX_ELEVATORS) {
+        throw std::invalid_argument("Number of elevators must be between " + std::to_string(MIN_ELEVATORS) +
+                                    " and " + std::to_string(MAX_ELEVATORS));
+    }
+    if (elevatorCapacity < 1) {
+        throw std::invalid_argument("Elevator capacity must be at least 1");
+    }
+    
+    floors.reserve(numFloors);
+    for (int i = 1; i <= numFloors; i++) {
+        floors.push_back(Floor(i, queuePool));
+    }
     
     // Create the elevators
+    elevators.reserve(numElevators);
+    committedBoarders.resize(numElevators);
+    dispatchScratch.resize(numElevators);
     for (int i = 0; i < numElevators; i++) {
-        elevators.push_back(Elevator(i, numFloors));
+        elevators.push_back(Elevator(fleet, floors, elevatorCapacity, clock, events));
     }
 }
 
-void Building::addFloor() {
-    floors.push_back(Floor(floors.size() + 1));
+bool Building::setCarParams(int elevatorIndex, const Elevator::Params& params) {
+    if (elevatorIndex < 0 || elevatorIndex >= static_cast<int>(elevators.size())) {
+        return false;
+    }
+    
+    elevators[elevatorIndex].setParams(params);
+    return true;
+}
+
+void Building::setElevatorCapacity(int capacity) {
+    if (capacity < 1) {
+        throw std::invalid_argument("Elevator capacity must be at least 1");
+    }
+    
+    elevatorCapacity = capacity;
+    for (auto& elevator : elevators) {
+        elevator.setCapacity(capacity);
+    }
 }
 
 void Building::addElevator() {
-    elevators.push_back(Elevator(elevators.size(), numFloors));
+    if (static_cast<int>(elevators.size()) >= MAX_ELEVATORS) {
+        return;
+    }
+    elevators.push_back(Elevator(fleet, floors, elevatorCapacity, clock, events));
+    committedBoarders.push_back(0);
+    dispatchScratch.push_back(0.0f);
 }
 
 void Building::addRequest(const Request& request) {
+    // Latch the hall button; a call that is already lit keeps its age
+    if (request.getFloor() >= 1 && request.getFloor() <= numFloors) {
+        floors[request.getFloor() - 1].pressButton(request.getDirection(), clock.now());
+    }
+    TRACE_EVENT(clock.now(), EventTrace::CALL_REGISTERED, -1, request.getFloor(), request.getDirection());
+    assignRequest(request);
+}
+
+void Building::assignRequest(const Request& request) {
     // Find the best elevator to handle this request
     Elevator* bestElevator = findBestElevator(request);
     if (bestElevator) {
+        TRACE_EVENT(clock.now(), EventTrace::CALL_ASSIGNED, bestElevator->getId(), request.getFloor(),
+                    request.getDirection());
         bestElevator->addRequest(request);
+    } else {
+        // Every car is full; hold the call until someone gets out
+        deferredRequests.push_back(request);
     }
 }
 
-void Building::update() {
-    // Update all elevators
-    for (auto& elevator : elevators) {
-        elevator.update();
+void Building::scheduleRequest(SimTime time, const Request& request) {
+    events.push(time, SimEvent::NEW_CALL, -1, 0, request.getFloor(), request.getDirection());
+}
+
+bool Building::addCarCall(int elevatorIndex, int floor) {
+    if (elevatorIndex < 0 || elevatorIndex >= static_cast<int>(elevators.size()) ||
+        floor < 1 || floor > numFloors) {
+        return false;
+    }
+    
+    TRACE_EVENT(clock.now(), EventTrace::CALL_REGISTERED, elevatorIndex, floor);
+    elevators[elevatorIndex].addRequest(Request(floor, Request::NONE));
+    return true;
+}
+
+bool Building::openCarDoors(int elevatorIndex) {
+    if (elevatorIndex < 0 || elevatorIndex >= static_cast<int>(elevators.size())) {
+        return false;
     }
+    
+    elevators[elevatorIndex].openDoors();
+    return true;
+}
+
+void Building::addPassenger(int origin, int destination, int journey) {
+    if (origin < 1 || origin > numFloors || destination < 1 || destination > numFloors ||
+        origin == destination) {
+        return;
+    }
+    
+    // Reuse the slot of a finished trip if there is one
+    int id;
+    if (freePassengers.empty()) {
+        id = passengers.size();
+        passengers.push_back(Passenger(id, origin, destination, clock.now(), journey));
+    } else {
+        id = freePassengers.back();
+        freePassengers.pop_back();
+        passengers[id] = Passenger(id, origin, destination, clock.now(), journey);
+    }
+    const Passenger& passenger = passengers[id];
+    floors[origin - 1].getWaiting().push(id);
+    
+    if (destinationDispatch) {
+        // Key the destination in and wait for the batch to be assigned
+        TRACE_EVENT(clock.now(), EventTrace::CALL_REGISTERED, -1, origin, passenger.getDirection());
+        DestinationDispatcher::Call call = {id, origin, destination, clock.now()};
+        if (destinationDispatch->addCall(call)) {
+            // A call on its own is assigned at once if waiting for others
+            // to batch it with would hold up a car that could take it
+            if (floors[origin - 1].getWaiting().size() == 1 &&
+                destinationDispatch->windowDelays(call, elevators, committedBoarders)) {
+                assignDestinationBatch();
+            } else {
+                events.push(clock.now() + destinationDispatch->getBatchWindow(), SimEvent::DISPATCH_BATCH, -1, 0);
+            }
+        }
+        return;
+    }
+    
+    // Press the hall button for the passenger's direction
+    addRequest(Request(origin, passenger.getDirection()));
+}
+
+void Building::schedulePassenger(SimTime time, int origin, int destination, int journey) {
+    events.push(time, SimEvent::NEW_PASSENGER, -1, 0, origin, Request::NONE, destination, journey);
+}
+
+void Building::takeCompletedLegs(std::vector<CompletedLeg>& legs) {
+    legs.insert(legs.end(), completedLegs.begin(), completedLegs.end());
+    completedLegs.clear();
+}
+
+void Building::update(double deltaSeconds) {
+    // Advance simulated time by an explicit step so runs are reproducible
+    runUntil(clock.now() + SimClock::fromSeconds(deltaSeconds));
+}
+
+void Building::runUntil(SimTime time) {
+    // Only cars with a pending state change cost anything here
+    while (!events.empty() && events.top().time <= time) {
+        SimEvent event = events.pop();
+        sampleUntil(event.time);
+        clock.advanceTo(event.time);
+        dispatchEvent(event);
+        eventsProcessed++;
+    }
+    sampleUntil(time);
+    clock.advanceTo(time);
+}
+
+bool Building::step() {
+    if (events.empty()) {
+        return false;
+    }
+    
+    SimEvent event = events.pop();
+    sampleUntil(event.time);
+    clock.advanceTo(event.time);
+    dispatchEvent(event);
+    eventsProcessed++;
+    return true;
+}
+
+void Building::setSampler(MetricsSampler* newSampler) {
+    sampler = newSampler;
+    if (sampler) {
+        sampler->start(*this);
+        nextSample = clock.now() + sampler->getInterval();
+    }
+}
+
+void Building::sampleUntil(SimTime time) {
+    // A sample sees the building as it was before the events at its time
+    while (sampler && nextSample <= time) {
+        clock.advanceTo(nextSample);
+        sampler->sample(*this);
+        nextSample += sampler->getInterval();
+    }
+}
+
+bool Building::hasPendingEvents() const {
+    return !events.empty();
+}
+
+long Building::getEventsProcessed() const {
+    return eventsProcessed;
+}
+
+void Building::dispatchEvent(const SimEvent& event) {
+    if (event.type == SimEvent::NEW_CALL) {
+        addRequest(Request(event.floor, event.direction));
+    }
+    else if (event.type == SimEvent::NEW_PASSENGER) {
+        addPassenger(event.floor, event.destination, event.journey);
+    }
+    else if (event.type == SimEvent::DISPATCH_BATCH) {
+        assignDestinationBatch();
+    }
+    else if (event.elevatorId >= 0 && event.elevatorId < static_cast<int>(elevators.size())) {
+        Elevator& elevator = elevators[event.elevatorId];
+        int floor = elevator.getCurrentFloor();
+        
+        if (!elevator.handleEvent(event)) {
+            return;
+        }
+        
+        // Load on opening, and sweep up late arrivals as the doors start closing
+        if (event.type == SimEvent::DOORS_OPENED || event.type == SimEvent::DOORS_CLOSE_TIMEOUT) {
+            exchangePassengers(elevator);
+        }
+        else if (event.type == SimEvent::DOORS_CLOSED) {
+            if (destinationDispatch) {
+                reassignLeftBehind(elevator, floor);
+            } else {
+                reissueHallCalls(floor);
+            }
+        }
+    }
+}
+
+void Building::exchangePassengers(Elevator& elevator) {
+    int floor = elevator.getCurrentFloor();
+    SimTime now = clock.now();
+    
+    // Unload first so the freed space can be used by waiting passengers
+    alightBuffer.clear();
+    elevator.alightPassengers(alightBuffer);
+    for (int id : alightBuffer) {
+        Passenger& passenger = passengers[id];
+        passenger.alight(now);
+        rideTimes.add(SimClock::toSeconds(passenger.getRideTime()));
+        passengersServed++;
+        if (passenger.getJourney() >= 0) {
+            completedLegs.push_back({passenger.getJourney(), floor, now});
+        }
+        freePassengers.push_back(id);
+    }
+    
+    // Freed space lets held calls be assigned again; calls no car can take
+    // yet go back into deferredRequests
+    if (!alightBuffer.empty() && !deferredRequests.empty()) {
+        heldRequests.swap(deferredRequests);
+        for (const Request& request : heldRequests) {
+            assignRequest(request);
+        }
+        heldRequests.clear();
+    }
+    
+    RingQueue& queue = floors[floor - 1].getWaiting();
+    if (destinationDispatch) {
+        // Only the passengers told to take this car get in, in arrival order
+        size_t kept = 0;
+        for (size_t i = 0; i < queue.size(); i++) {
+            Passenger& passenger = passengers[queue[i]];
+            if (passenger.getAssignedCar() == elevator.getId() &&
+                elevator.boardPassenger(passenger.getId(), passenger.getDestination())) {
+                passenger.board(now);
+                waitTimes.add(SimClock::toSeconds(passenger.getWaitTime()));
+                committedBoarders[elevator.getId()]--;
+            } else {
+                queue[kept++] = queue[i];
+            }
+        }
+        queue.truncate(kept);
+        return;
+    }
+    
+    // Board waiting passengers going the way the car leaves, in arrival
+    // order, until the car is full. An idle car takes whoever is first in
+    // line and then leaves their way; the rest keep waiting with their call lit.
+    Request::Direction departure = elevator.getDepartureDirection();
+    size_t kept = 0;
+    for (size_t i = 0; i < queue.size(); i++) {
+        Passenger& passenger = passengers[queue[i]];
+        if ((departure == Request::NONE || passenger.getDirection() == departure) &&
+            elevator.boardPassenger(passenger.getId(), passenger.getDestination())) {
+            passenger.board(now);
+            waitTimes.add(SimClock::toSeconds(passenger.getWaitTime()));
+            departure = passenger.getDirection();
+        } else {
+            queue[kept++] = queue[i];
+        }
+    }
+    queue.truncate(kept);
+    
+    // A car that had not committed to a direction answers the call of the
+    // passengers it took
+    if (departure != Request::NONE) {
+        floors[floor - 1].clearCall(departure);
+    }
+}
+
+void Building::reissueHallCalls(int floor) {
+    // A call the car that just left did not answer keeps its age and is
+    // assigned again; passengers left behind by a full car press theirs anew
+    Floor& landing = floors[floor - 1];
+    bool needUp = landing.hasCall(Request::UP);
+    bool needDown = landing.hasCall(Request::DOWN);
+    const RingQueue& queue = landing.getWaiting();
+    for (size_t i = 0; i < queue.size(); i++) {
+        if (passengers[queue[i]].getDirection() == Request::UP) {
+            needUp = true;
+        } else {
+            needDown = true;
+        }
+    }
+    
+    // A car already on its way here answers them on arrival, so they are
+    // only lit again
+    bool carComing = false;
+    for (const auto& elevator : elevators) {
+        if (elevator.countStopsBetween(floor, floor) > 0) {
+            carComing = true;
+            break;
+        }
+    }
+    
+    if (needUp) {
+        carComing ? (void)landing.pressButton(Request::UP, clock.now()) : addRequest(Request(floor, Request::UP));
+    }
+    if (needDown) {
+        carComing ? (void)landing.pressButton(Request::DOWN, clock.now()) : addRequest(Request(floor, Request::DOWN));
+    }
+}
+
+void Building::assignDestinationBatch() {
+    // A batch scheduled before switching back to hall calls
+    if (!destinationDispatch || !destinationDispatch->hasPendingCalls()) {
+        return;
+    }
+    
+    assignmentBuffer.clear();
+    destinationDispatch->assignBatch(clock.now(), elevators, committedBoarders, assignmentBuffer);
+    for (const auto& assignment : assignmentBuffer) {
+        Passenger& passenger = passengers[assignment.passenger];
+        passenger.assignCar(assignment.car);
+        committedBoarders[assignment.car]++;
+        
+        Request pickup(passenger.getOrigin(), passenger.getDirection());
+        TRACE_EVENT(clock.now(), EventTrace::CALL_ASSIGNED, assignment.car, pickup.getFloor(), pickup.getDirection());
+        elevators[assignment.car].addRequest(pickup);
+    }
+    
+    // Calls no car had room for go into the next batch
+    if (destinationDispatch->hasPendingCalls()) {
+        events.push(clock.now() + destinationDispatch->getBatchWindow(), SimEvent::DISPATCH_BATCH, -1, 0);
+    }
+}
+
+void Building::reassignLeftBehind(const Elevator& elevator, int floor) {
+    // A car still due back here will pick its passengers up then
+    if (elevator.countStopsBetween(floor, floor) > 0) {
+        return;
+    }
+    
+    // Passengers the car had no room for call again and join the next batch
+    const RingQueue& queue = floors[floor - 1].getWaiting();
+    for (size_t i = 0; i < queue.size(); i++) {
+        int id = queue[i];
+        Passenger& passenger = passengers[id];
+        if (passenger.getAssignedCar() != elevator.getId()) {
+            continue;
+        }
+        passenger.assignCar(-1);
+        committedBoarders[elevator.getId()]--;
+        if (destinationDispatch->addCall({id, floor, passenger.getDestination(), passenger.getSpawnTime()})) {
+            events.push(clock.now() + destinationDispatch->getBatchWindow(), SimEvent::DISPATCH_BATCH, -1, 0);
+        }
+    }
+}
+
+bool Building::isIdle() const {
+    for (const auto& elevator : elevators) {
+        if (!elevator.isIdle()) {
+            return false;
+        }
+    }
+    return true;
 }
 
 int Building::getNumFloors() const {
@@ -48,51 +424,264 @@ const std::vector<Elevator>& Building::getElevators() const {
     return elevators;
 }
 
-std::vector<Floor>& Building::getFloors() {
+const std::vector<Floor>& Building::getFloors() const {
     return floors;
 }
 
-Elevator* Building::findBestElevator(const Request& request) {
-    if (elevators.empty()) {
-        return nullptr;
+void Building::setDispatchStrategy(std::unique_ptr<DispatchStrategy> strategy) {
+    if (strategy) {
+        dispatcher = std::move(strategy);
     }
-    
-    // If there's only one elevator, it's the best choice
-    if (elevators.size() == 1) {
-        return &elevators[0];
+}
+
+void Building::setDestinationDispatch(SimTime batchWindow) {
+    if (batchWindow > 0) {
+        if (destinationDispatch) {
+            destinationDispatch->setBatchWindow(batchWindow);
+        } else {
+            destinationDispatch.reset(new DestinationDispatcher(batchWindow, numFloors));
+        }
+        return;
+    }
+    if (!destinationDispatch) {
+        return;
     }
     
-    // Find the best elevator based on proximity and direction
-    Elevator* bestElevator = nullptr;
-    int minDistance = numFloors + 1; // More than the maximum possible distance
+    // Back to hall buttons: whoever is waiting boards the first car going
+    // their way, so unassigned calls are pressed as hall calls
+    std::unique_ptr<DestinationDispatcher> batching = std::move(destinationDispatch);
+    for (auto& passenger : passengers) {
+        passenger.assignCar(-1);
+    }
+    std::fill(committedBoarders.begin(), committedBoarders.end(), 0);
+    for (const auto& call : batching->getPendingCalls()) {
+        addRequest(Request(call.origin, passengers[call.passenger].getDirection()));
+    }
+}
+
+SimTime Building::getDestinationBatchWindow() const {
+    return destinationDispatch ? destinationDispatch->getBatchWindow() : 0;
+}
+
+void Building::reset() {
+    sampler = nullptr;
+    clock.reset();
+    events.clear();
+    for (auto& elevator : elevators) {
+        elevator.reset();
+    }
+    for (auto& floor : floors) {
+        floor.reset();
+    }
+    if (destinationDispatch) {
+        destinationDispatch->clear();
+    }
+    std::fill(committedBoarders.begin(), committedBoarders.end(), 0);
     
+    passengers.clear();
+    freePassengers.clear();
+    deferredRequests.clear();
+    completedLegs.clear();
+    resetStatistics();
+}
+
+void Building::resetStatistics() {
+    eventsProcessed = 0;
+    passengersServed = 0;
+    waitTimes.clear();
+    rideTimes.clear();
     for (auto& elevator : elevators) {
-        // Calculate distance to the requested floor
-        int distance = std::abs(elevator.getCurrentFloor() - request.getFloor());
-        
-        // If elevator is idle or heading in the same direction as the request, it's preferred
-        if (!elevator.isMoving() || 
-            (elevator.getCurrentDirection() == request.getDirection() && 
-             ((request.getDirection() == Request::UP && elevator.getCurrentFloor() < request.getFloor()) ||
-              (request.getDirection() == Request::DOWN && elevator.getCurrentFloor() > request.getFloor())))) {
-            
-            if (distance < minDistance) {
-                minDistance = distance;
-                bestElevator = &elevator;
+        elevator.resetStatistics();
+    }
+}
+
+void Building::save(BinaryWriter& out) const {
+    out.writeInt(numFloors);
+    out.writeInt(elevators.size());
+    out.writeInt(elevatorCapacity);
+    
+    clock.save(out);
+    events.save(out);
+    out.writeInt64(eventsProcessed);
+    fleet.save(out);
+    for (const auto& elevator : elevators) {
+        elevator.save(out);
+    }
+    out.writeUInt64(floors.size());
+    for (const auto& floor : floors) {
+        floor.save(out);
+    }
+    
+    out.writeString(dispatcher->getName());
+    out.writeDouble(dispatcher->getEnergyWeight());
+    
+    out.writeUInt64(passengers.size());
+    for (const auto& passenger : passengers) {
+        passenger.save(out);
+    }
+    out.writeUInt64(freePassengers.size());
+    for (int id : freePassengers) {
+        out.writeInt(id);
+    }
+    out.writeUInt64(deferredRequests.size());
+    for (const auto& request : deferredRequests) {
+        out.writeInt(request.getFloor());
+        out.writeUInt8(request.getDirection());
+    }
+    out.writeUInt64(completedLegs.size());
+    for (const auto& leg : completedLegs) {
+        out.writeInt(leg.journey);
+        out.writeInt(leg.floor);
+        out.writeInt64(leg.time);
+    }
+    out.writeBool(destinationDispatch != nullptr);
+    if (destinationDispatch) {
+        destinationDispatch->save(out);
+    }
+    out.writeInt(passengersServed);
+    waitTimes.save(out);
+    rideTimes.save(out);
+}
+
+std::unique_ptr<Building> Building::restore(BinaryReader& in) {
+    int savedFloors = in.readInt();
+    int savedElevators = in.readInt();
+    int savedCapacity = in.readInt();
+    if (savedFloors < MIN_FLOORS || savedFloors > MAX_FLOORS || savedElevators < MIN_ELEVATORS ||
+        savedElevators > MAX_ELEVATORS || savedCapacity < 1 || savedCapacity > (1 << 20)) {
+        throw std::runtime_error("Snapshot is corrupt: building size out of range"); // Cars hold at most 2^20 riders
+    }
+    std::unique_ptr<Building> building(new Building(savedFloors, savedElevators, savedCapacity));
+    
+    building->clock.restore(in);
+    building->events.restore(in);
+    building->eventsProcessed = in.readInt64();
+    building->fleet.restore(in);
+    for (auto& elevator : building->elevators) {
+        elevator.restore(in);
+    }
+    if (in.readCount(MAX_FLOORS) != building->floors.size()) {
+        throw std::runtime_error("Snapshot is corrupt: floor count does not match the building");
+    }
+    for (auto& floor : building->floors) {
+        floor.restore(in);
+    }
+    
+    std::string strategyName = in.readString();
+    std::unique_ptr<DispatchStrategy> strategy = DispatchStrategy::create(strategyName);
+    if (!strategy) {
+        throw std::runtime_error("Snapshot uses an unknown dispatch strategy: " + strategyName);
+    }
+    strategy->setEnergyWeight(in.readDouble());
+    building->setDispatchStrategy(std::move(strategy));
+    
+    size_t passengerCount = in.readCount(1u << 30);
+    building->passengers.reserve(passengerCount);
+    for (size_t i = 0; i < passengerCount; i++) {
+        building->passengers.push_back(Passenger::restore(in));
+        const Passenger& passenger = building->passengers.back();
+        if (passenger.getId() != static_cast<int>(i)) {
+            throw std::runtime_error("Snapshot is corrupt: passenger out of place");
+        }
+        if (passenger.getOrigin() < 1 || passenger.getOrigin() > savedFloors ||
+            passenger.getDestination() < 1 || passenger.getDestination() > savedFloors) {
+            throw std::runtime_error("Snapshot is corrupt: passenger outside the building");
+        }
+    }
+    for (const auto& elevator : building->elevators) {
+        elevator.checkRiders(passengerCount);
+    }
+    size_t freeCount = in.readCount(passengerCount);
+    for (size_t i = 0; i < freeCount; i++) {
+        int id = in.readInt();
+        if (id < 0 || static_cast<size_t>(id) >= passengerCount) {
+            throw std::runtime_error("Snapshot is corrupt: unknown free passenger slot");
+        }
+        building->freePassengers.push_back(id);
+    }
+    size_t deferred = in.readCount(1u << 30);
+    for (size_t i = 0; i < deferred; i++) {
+        int floor = in.readInt();
+        if (floor < 1 || floor > savedFloors) {
+            throw std::runtime_error("Snapshot is corrupt: deferred call outside the building");
+        }
+        building->deferredRequests.push_back(Request(floor, static_cast<Request::Direction>(in.readUInt8())));
+    }
+    size_t legs = in.readCount(passengerCount);
+    for (size_t i = 0; i < legs; i++) {
+        CompletedLeg leg;
+        leg.journey = in.readInt();
+        leg.floor = in.readInt();
+        leg.time = in.readInt64();
+        building->completedLegs.push_back(leg);
+    }
+    if (in.readBool()) {
+        building->destinationDispatch.reset(new DestinationDispatcher(1, savedFloors));
+        building->destinationDispatch->restore(in);
+        for (const auto& call : building->destinationDispatch->getPendingCalls()) {
+            if (call.passenger < 0 || static_cast<size_t>(call.passenger) >= passengerCount) {
+                throw std::runtime_error("Snapshot is corrupt: unknown destination call passenger");
             }
         }
     }
     
-    // If no elevator was found based on direction, just pick the closest one
-    if (!bestElevator) {
-        for (auto& elevator : elevators) {
-            int distance = std::abs(elevator.getCurrentFloor() - request.getFloor());
-            if (distance < minDistance) {
-                minDistance = distance;
-                bestElevator = &elevator;
+    // Assigned passengers still waiting are what each car has promised to collect
+    for (const auto& floor : building->floors) {
+        const RingQueue& queue = floor.getWaiting();
+        for (size_t i = 0; i < queue.size(); i++) {
+            int id = queue[i];
+            if (id < 0 || static_cast<size_t>(id) >= passengerCount) {
+                throw std::runtime_error("Snapshot is corrupt: unknown waiting passenger");
+            }
+            int car = building->passengers[id].getAssignedCar();
+            if (car >= savedElevators) {
+                throw std::runtime_error("Snapshot is corrupt: passenger assigned to an unknown car");
+            }
+            if (car >= 0) {
+                building->committedBoarders[car]++;
             }
         }
     }
+    building->passengersServed = in.readInt();
+    building->waitTimes.restore(in);
+    building->rideTimes.restore(in);
+    return building;
+}
+
+const DispatchStrategy& Building::getDispatchStrategy() const {
+    return *dispatcher;
+}
+
+const FleetState& Building::getFleet() const {
+    return fleet;
+}
+
+const SimClock& Building::getClock() const {
+    return clock;
+}
+
+const std::vector<Passenger>& Building::getPassengers() const {
+    return passengers;
+}
+
+int Building::getPassengersServed() const {
+    return passengersServed;
+}
+
+const LatencyStats& Building::getWaitTimes() const {
+    return waitTimes;
+}
+
+const LatencyStats& Building::getRideTimes() const {
+    return rideTimes;
+}
+
+Elevator* Building::findBestElevator(const Request& request) {
+    if (elevators.empty()) {
+        return nullptr;
+    }
     
-    return bestElevator;
-}
\ No newline at end of file
+    // The active dispatch strategy picks the car
+    int index = dispatcher->selectElevator(request, elevators, fleet, floors, clock.now(), dispatchScratch.data());
+    return (index >= 0) ? &elevators[index] : nullptr;
+}
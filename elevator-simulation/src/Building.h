@@ -1,31 +1,166 @@
 #ifndef BUILDING_H
 #define BUILDING_H
 
+#include <memory>
 #include <vector>
+#include "BinaryStream.h"
+#include "BlockPool.h"
+#include "DestinationDispatcher.h"
+#include "DispatchStrategy.h"
 #include "Elevator.h"
+#include "EventQueue.h"
+#include "FleetState.h"
 #include "Floor.h"
+#include "LatencyStats.h"
+#include "MetricsSampler.h"
+#include "Passenger.h"
 #include "Request.h"
+#include "SimClock.h"
 
 class Building {
 public:
-    Building(int numFloors, int numElevators);
+    static const int DEFAULT_ELEVATOR_CAPACITY = 5;
+    
+    // Supported building sizes
+    static const int MIN_FLOORS = 2;
+    static const int MAX_FLOORS = 256;
+    static const int MIN_ELEVATORS = 1;
+    static const int MAX_ELEVATORS = 64;
+    
+    Building(int numFloors, int numElevators, int elevatorCapacity = DEFAULT_ELEVATOR_CAPACITY);
+    
+    // Elevators hold a pointer to the building's clock, so a building
+    // cannot be copied
+    Building(const Building&) = delete;
+    Building& operator=(const Building&) = delete;
     
     void addRequest(const Request& request);
-    void update();
-    void addFloor();
+    void scheduleRequest(SimTime time, const Request& request);
+    
+    // Car button pressed inside a specific elevator; false if out of range
+    bool addCarCall(int elevatorIndex, int floor);
+    
+    // Door-open button inside a specific elevator; false if out of range
+    bool openCarDoors(int elevatorIndex);
+    
+    // Passengers wait at their origin floor and register a hall call
+    void addPassenger(int origin, int destination, int journey = -1);
+    void schedulePassenger(SimTime time, int origin, int destination, int journey = -1);
+    
+    // Passengers on a leg of a campus journey, collected as they alight so
+    // the campus can send them on to their next bank
+    struct CompletedLeg {
+        int journey;
+        int floor;
+        SimTime time;
+    };
+    void takeCompletedLegs(std::vector<CompletedLeg>& legs); // Appends, then forgets them
+    
+    // Advance simulated time, processing every event that falls due
+    void update(double deltaSeconds);
+    void runUntil(SimTime time);
+    
+    // Jump straight to the next event; returns false once nothing is pending
+    bool step();
+    bool hasPendingEvents() const;
+    long getEventsProcessed() const;
+    
+    // Runtime tuning; both apply from each car's next run or door operation
+    bool setCarParams(int elevatorIndex, const Elevator::Params& params); // False if out of range
+    void setElevatorCapacity(int capacity);
+    
     void addElevator();
     
+    bool isIdle() const;
+    
     int getNumFloors() const;
     int getNumElevators() const;
     const std::vector<Elevator>& getElevators() const;
-    std::vector<Floor>& getFloors();
+    const FleetState& getFleet() const; // Hot state of every car, one array per field
+    const std::vector<Floor>& getFloors() const; // Hall calls and waiting passengers per floor
+    const SimClock& getClock() const;
+    
+    // Dispatch strategy used to assign hall calls to cars
+    void setDispatchStrategy(std::unique_ptr<DispatchStrategy> strategy);
+    const DispatchStrategy& getDispatchStrategy() const;
+    
+    // Destination control instead of up/down hall buttons: passengers'
+    // calls are batched over the window and each is told which car to
+    // take. Zero switches back to hall calls, registering any calls still
+    // waiting for a batch as hall calls.
+    void setDestinationDispatch(SimTime batchWindow);
+    SimTime getDestinationBatchWindow() const; // Zero when using hall calls
+    
+    // Start a new run: back to time zero with no passengers, calls or
+    // pending events and every car parked at floor 1, as when the building
+    // was constructed. Car settings, capacity and the dispatch mode are
+    // kept, and so is all the memory the previous run grew into, so
+    // repeated runs of a similar scenario allocate nothing. A sampler is
+    // detached, since its samples belong to the previous run.
+    void reset();
+    
+    // Hand the building to the sampler every time simulated time reaches
+    // a multiple of its interval, counting from now. The sampler is not
+    // owned, is not part of a snapshot and does not change the run; null
+    // stops sampling.
+    void setSampler(MetricsSampler* sampler);
+    
+    // Start measuring afresh from now: clears the trip statistics, event
+    // count and every car's statistics, but no passenger or car state
+    void resetStatistics();
+    
+    // Checkpointing of the complete model state: clock, pending events,
+    // every car with its stops and riders, hall calls, passengers, waiting
+    // queues, held calls, statistics and the dispatch strategy. A restored building
+    // continues event for event exactly as the original would have.
+    void save(BinaryWriter& out) const;
+    static std::unique_ptr<Building> restore(BinaryReader& in);
+    
+    // Trip metrics. Passenger slots are reused once their passenger has
+    // alighted, so these are the passengers in the building plus finished
+    // trips whose slot has not been taken again yet.
+    const std::vector<Passenger>& getPassengers() const;
+    int getPassengersServed() const;
+    const LatencyStats& getWaitTimes() const;
+    const LatencyStats& getRideTimes() const;
     
 private:
     int numFloors;
-    std::vector<Elevator> elevators;
+    int elevatorCapacity;
+    SimClock clock;
+    EventQueue events;
+    long eventsProcessed;
+    FleetState fleet;
+    BlockPool queuePool; // Storage of the waiting queues; outlives the floors
     std::vector<Floor> floors;
+    std::vector<Elevator> elevators;
+    std::unique_ptr<DispatchStrategy> dispatcher;
+    std::unique_ptr<DestinationDispatcher> destinationDispatch; // Null when using hall calls
+    std::vector<int> committedBoarders; // Per car, assigned passengers not yet on board
+    std::vector<DestinationDispatcher::Assignment> assignmentBuffer;
+    std::vector<float> dispatchScratch; // One per car, for the dispatch strategy
+    
+    // Passenger bookkeeping
+    std::vector<Passenger> passengers; // Slots, indexed by passenger id
+    std::vector<int> freePassengers;   // Slots of finished trips
+    std::vector<int> alightBuffer;
+    std::vector<Request> deferredRequests; // Hall calls waiting for a car with space
+    std::vector<Request> heldRequests;     // Scratch for reassigning the deferred calls
+    std::vector<CompletedLeg> completedLegs;
+    int passengersServed;
+    LatencyStats waitTimes;
+    LatencyStats rideTimes;
+    MetricsSampler* sampler;
+    SimTime nextSample;
     
     Elevator* findBestElevator(const Request& request);
+    void assignRequest(const Request& request); // Dispatch without registering the call again
+    void dispatchEvent(const SimEvent& event);
+    void sampleUntil(SimTime time); // Every sample due at or before time
+    void exchangePassengers(Elevator& elevator);
+    void reissueHallCalls(int floor);
+    void assignDestinationBatch();
+    void reassignLeftBehind(const Elevator& elevator, int floor);
 };
 
 #endif // BUILDING_H
\ No newline at end of file
@@ -0,0 +1,488 @@
+#include "Campus.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include "DispatchStrategy.h"
+
+namespace {
+
+long parseInteger(const std::string& text, long low, long high, const char* what) {
+    size_t used = 0;
+    long value = 0;
+    try {
+        value = std::stol(text, &used);
+    }
+    catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != text.size()) {
+        throw std::invalid_argument(std::string(what) + ": expected an integer");
+    }
+    if (value < low || value > high) {
+        throw std::out_of_range(std::string(what) + " must be between " + std::to_string(low) +
+                                " and " + std::to_string(high));
+    }
+    return value;
+}
+
+double parseNumber(const std::string& text, double low, const char* what) {
+    size_t used = 0;
+    double value = 0.0;
+    try {
+        value = std::stod(text, &used);
+    }
+    catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != text.size()) {
+        throw std::invalid_argument(std::string(what) + ": expected a number");
+    }
+    if (!(value > low)) {
+        throw std::out_of_range(std::string(what) + " must be greater than " + std::to_string(low));
+    }
+    return value;
+}
+
+// "1,21-40" -> 1, 21, 22, ..., 40
+std::vector<int> parseFloors(const std::string& text) {
+    std::vector<int> floors;
+    std::stringstream list(text);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        size_t dash = item.find('-');
+        int first = parseInteger(item.substr(0, dash), 1, Building::MAX_FLOORS, "floor");
+        int last = (dash == std::string::npos) ? first
+                 : parseInteger(item.substr(dash + 1), first, Building::MAX_FLOORS, "floor range end");
+        for (int floor = first; floor <= last; floor++) {
+            floors.push_back(floor);
+        }
+    }
+    std::sort(floors.begin(), floors.end());
+    floors.erase(std::unique(floors.begin(), floors.end()), floors.end());
+    return floors;
+}
+
+bool sharesFloor(const Campus::Bank& a, const Campus::Bank& b) {
+    std::vector<int> shared;
+    std::set_intersection(a.floors.begin(), a.floors.end(), b.floors.begin(), b.floors.end(),
+                          std::back_inserter(shared));
+    return !shared.empty();
+}
+
+// Worker threads that each advance their own shard of banks to the end of
+// a window, then wait for the next one. The calling thread runs shard 0.
+class ShardPool {
+public:
+    ShardPool(std::vector<std::unique_ptr<Building>>& banks, int shards)
+        : banks(banks), shards(shards), windowEnd(0), window(0), running(0), stopping(false) {
+        for (int shard = 1; shard < shards; shard++) {
+            workers.emplace_back(&ShardPool::work, this, shard);
+        }
+    }
+    
+    ~ShardPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        windowStarted.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+    
+    void runWindow(SimTime end) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            windowEnd = end;
+            window++;
+            running = shards - 1;
+        }
+        windowStarted.notify_all();
+        runShard(0, end);
+        
+        std::unique_lock<std::mutex> lock(mutex);
+        windowFinished.wait(lock, [this] { return running == 0; });
+    }
+    
+private:
+    std::vector<std::unique_ptr<Building>>& banks;
+    int shards;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable windowStarted;
+    std::condition_variable windowFinished;
+    SimTime windowEnd;
+    std::uint64_t window;
+    int running;
+    bool stopping;
+    
+    void runShard(int shard, SimTime end) {
+        for (size_t bank = shard; bank < banks.size(); bank += shards) {
+            banks[bank]->runUntil(end);
+        }
+    }
+    
+    void work(int shard) {
+        std::uint64_t done = 0;
+        while (true) {
+            SimTime end;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                windowStarted.wait(lock, [this, done] { return stopping || window != done; });
+                if (stopping) {
+                    return;
+                }
+                done = window;
+                end = windowEnd;
+            }
+            
+            runShard(shard, end);
+            
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--running == 0) {
+                windowFinished.notify_one();
+            }
+        }
+    }
+};
+
+}
+
+Campus::Layout Campus::Layout::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Could not open campus file: " + path);
+    }
+    
+    Layout layout;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        std::istringstream fields(line);
+        std::string kind;
+        if (!(fields >> kind)) {
+            continue;
+        }
+        
+        try {
+            std::vector<std::string> args;
+            std::string arg;
+            while (fields >> arg) {
+                args.push_back(arg);
+            }
+            
+            if (kind.compare(0, 14, "transfer_time=") == 0 && args.empty()) {
+                layout.transferTime = parseNumber(kind.substr(14), 0.0, "transfer_time");
+            } else if (kind == "tower" && args.size() == 4) {
+                Tower tower;
+                tower.name = args[0];
+                for (const auto& other : layout.towers) {
+                    if (other.name == tower.name) {
+                        throw std::invalid_argument("tower '" + tower.name + "' is already defined");
+                    }
+                }
+                tower.numFloors = parseInteger(args[1], Building::MIN_FLOORS, Building::MAX_FLOORS, "floors");
+                if (!TrafficGenerator::parsePattern(args[2], tower.pattern)) {
+                    throw std::invalid_argument("unknown traffic pattern '" + args[2] + "'");
+                }
+                tower.passengersPerHour = parseNumber(args[3], 0.0, "passengers per hour");
+                layout.towers.push_back(tower);
+            } else if (kind == "bank" && args.size() == 5) {
+                Bank bank;
+                bank.tower = -1;
+                for (size_t i = 0; i < layout.towers.size(); i++) {
+                    if (layout.towers[i].name == args[0]) {
+                        bank.tower = i;
+                    }
+                }
+                if (bank.tower < 0) {
+                    throw std::invalid_argument("unknown tower '" + args[0] + "'");
+                }
+                bank.name = args[1];
+                bank.numElevators = parseInteger(args[2], Building::MIN_ELEVATORS, Building::MAX_ELEVATORS,
+                                                 "elevators");
+                bank.capacity = parseInteger(args[3], 1, 1000, "capacity");
+                bank.floors = parseFloors(args[4]);
+                layout.banks.push_back(bank);
+            } else {
+                throw std::invalid_argument("expected 'transfer_time=<seconds>', "
+                                            "'tower <name> <floors> <traffic> <passengers/hour>' or "
+                                            "'bank <tower> <name> <elevators> <capacity> <floors>'");
+            }
+        }
+        catch (const std::exception& e) {
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": " + e.what());
+        }
+    }
+    
+    try {
+        layout.validate();
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error(path + ": " + e.what());
+    }
+    return layout;
+}
+
+void Campus::Layout::validate() const {
+    if (!(transferTime > 0.0)) {
+        throw std::invalid_argument("Transfer time must be positive");
+    }
+    if (towers.empty()) {
+        throw std::invalid_argument("A campus needs at least one tower");
+    }
+    
+    for (size_t t = 0; t < towers.size(); t++) {
+        const Tower& tower = towers[t];
+        std::vector<int> members;
+        std::vector<bool> served(tower.numFloors + 1, false);
+        for (size_t b = 0; b < banks.size(); b++) {
+            const Bank& bank = banks[b];
+            if (bank.tower != static_cast<int>(t)) {
+                continue;
+            }
+            if (bank.floors.size() < 2 || bank.floors.front() < 1 || bank.floors.back() > tower.numFloors) {
+                throw std::invalid_argument("Bank '" + bank.name + "' must serve at least two floors of tower '" +
+                                            tower.name + "'");
+            }
+            for (int floor : bank.floors) {
+                served[floor] = true;
+            }
+            members.push_back(b);
+        }
+        for (int floor = 1; floor <= tower.numFloors; floor++) {
+            if (!served[floor]) {
+                throw std::invalid_argument("No bank serves floor " + std::to_string(floor) +
+                                            " of tower '" + tower.name + "'");
+            }
+        }
+        
+        // Every bank must be reachable from the first through shared floors
+        std::vector<bool> reached(members.size(), false);
+        std::vector<size_t> frontier(1, 0);
+        reached[0] = true;
+        while (!frontier.empty()) {
+            size_t current = frontier.back();
+            frontier.pop_back();
+            for (size_t other = 0; other < members.size(); other++) {
+                if (!reached[other] && sharesFloor(banks[members[current]], banks[members[other]])) {
+                    reached[other] = true;
+                    frontier.push_back(other);
+                }
+            }
+        }
+        for (size_t i = 0; i < members.size(); i++) {
+            if (!reached[i]) {
+                throw std::invalid_argument("Bank '" + banks[members[i]].name + "' shares no transfer floor with "
+                                            "the rest of tower '" + tower.name + "'");
+            }
+        }
+    }
+}
+
+Campus::Campus(const Layout& layout, std::uint64_t seed)
+    : layout(layout), journeysCompleted(0), transfers(0), now(0), shardCount(0) {
+    this->layout.validate();
+    
+    towerBanks.resize(layout.towers.size());
+    for (size_t b = 0; b < layout.banks.size(); b++) {
+        const Bank& bank = layout.banks[b];
+        banks.emplace_back(new Building(bank.floors.size(), bank.numElevators, bank.capacity));
+        localFloors.emplace_back(layout.towers[bank.tower].numFloors + 1, 0);
+        for (size_t i = 0; i < bank.floors.size(); i++) {
+            localFloors.back()[bank.floors[i]] = i + 1;
+        }
+        towerBanks[bank.tower].push_back(b);
+    }
+    
+    // Each tower draws from its own stream, so adding a tower leaves the
+    // others' passengers unchanged
+    for (size_t t = 0; t < layout.towers.size(); t++) {
+        const Tower& tower = layout.towers[t];
+        traffic.emplace_back(new TrafficGenerator(tower.numFloors, tower.passengersPerHour, seed + t));
+        traffic.back()->setPattern(tower.pattern);
+        nextTrips.push_back(traffic.back()->next());
+    }
+}
+
+void Campus::setDispatchStrategy(const std::string& name) {
+    for (auto& bank : banks) {
+        std::unique_ptr<DispatchStrategy> strategy = DispatchStrategy::create(name);
+        if (!strategy) {
+            throw std::invalid_argument("Unknown dispatch strategy: " + name);
+        }
+        bank->setDispatchStrategy(std::move(strategy));
+    }
+}
+
+void Campus::run(SimTime endTime, int threads) {
+    if (threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    shardCount = std::min<int>(threads, banks.size());
+    ShardPool pool(banks, shardCount);
+    
+    // Nothing crosses between banks in less than the transfer time, so
+    // within a window of that length every bank can run on its own
+    SimTime window = SimClock::fromSeconds(layout.transferTime);
+    do {
+        SimTime windowEnd = now + window;
+        startArrivals(windowEnd, endTime);
+        pool.runWindow(windowEnd);
+        now = windowEnd;
+        handOverTransfers();
+    } while (now < endTime || hasPendingEvents());
+}
+
+void Campus::startArrivals(SimTime windowEnd, SimTime endTime) {
+    SimTime last = std::min(windowEnd, endTime);
+    for (size_t t = 0; t < traffic.size(); t++) {
+        while (nextTrips[t].time < last) {
+            const TrafficGenerator::Trip& trip = nextTrips[t];
+            journeys.push_back({static_cast<int>(t), trip.destination, trip.time});
+            startLeg(journeys.size() - 1, trip.origin, trip.time);
+            nextTrips[t] = traffic[t]->next();
+        }
+    }
+}
+
+void Campus::handOverTransfers() {
+    // In bank order, so the hand-over does not depend on which shard
+    // finished first
+    for (size_t b = 0; b < banks.size(); b++) {
+        legBuffer.clear();
+        banks[b]->takeCompletedLegs(legBuffer);
+        for (const Building::CompletedLeg& leg : legBuffer) {
+            const Journey& journey = journeys[leg.journey];
+            int floor = layout.banks[b].floors[leg.floor - 1];
+            if (floor == journey.destination) {
+                journeyTimes.add(SimClock::toSeconds(leg.time - journey.start));
+                journeysCompleted++;
+            } else {
+                transfers++;
+                startLeg(leg.journey, floor, leg.time + SimClock::fromSeconds(layout.transferTime));
+            }
+        }
+    }
+}
+
+void Campus::startLeg(int journey, int from, SimTime time) {
+    const Journey& trip = journeys[journey];
+    int bank = 0;
+    int exit = 0;
+    if (!planLeg(trip.tower, from, trip.destination, bank, exit)) {
+        return;
+    }
+    banks[bank]->schedulePassenger(time, localFloors[bank][from], localFloors[bank][exit], journey);
+}
+
+bool Campus::planLeg(int tower, int from, int to, int& bank, int& exit) const {
+    // Breadth first over the tower's banks, so the route has the fewest
+    // changes; ties go to the bank listed first
+    const std::vector<int>& candidates = towerBanks[tower];
+    std::vector<int> parent(candidates.size(), -1);
+    std::vector<int> entry(candidates.size(), 0); // Floor where the route boards each bank
+    std::vector<bool> seen(candidates.size(), false);
+    std::vector<size_t> queue;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (localFloors[candidates[i]][from]) {
+            seen[i] = true;
+            entry[i] = from;
+            queue.push_back(i);
+        }
+    }
+    
+    for (size_t head = 0; head < queue.size(); head++) {
+        size_t current = queue[head];
+        if (localFloors[candidates[current]][to]) {
+            // Walk back to the first bank of the route
+            int next = to;
+            while (parent[current] >= 0) {
+                next = entry[current];
+                current = parent[current];
+            }
+            bank = candidates[current];
+            exit = next;
+            return true;
+        }
+        
+        // Change at the shared floor closest to where this bank was boarded
+        for (size_t other = 0; other < candidates.size(); other++) {
+            if (seen[other]) {
+                continue;
+            }
+            int transfer = 0;
+            for (int floor : layout.banks[candidates[other]].floors) {
+                if (localFloors[candidates[current]][floor] &&
+                    (!transfer || std::abs(floor - entry[current]) < std::abs(transfer - entry[current]))) {
+                    transfer = floor;
+                }
+            }
+            if (transfer) {
+                seen[other] = true;
+                parent[other] = current;
+                entry[other] = transfer;
+                queue.push_back(other);
+            }
+        }
+    }
+    return false;
+}
+
+bool Campus::hasPendingEvents() const {
+    for (const auto& bank : banks) {
+        if (bank->hasPendingEvents()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const Campus::Layout& Campus::getLayout() const {
+    return layout;
+}
+
+const Building& Campus::getBank(int index) const {
+    return *banks[index];
+}
+
+int Campus::getNumBanks() const {
+    return banks.size();
+}
+
+int Campus::getShardCount() const {
+    return shardCount;
+}
+
+SimTime Campus::getTime() const {
+    return now;
+}
+
+long Campus::getJourneysStarted() const {
+    return journeys.size();
+}
+
+long Campus::getJourneysCompleted() const {
+    return journeysCompleted;
+}
+
+long Campus::getTransfers() const {
+    return transfers;
+}
+
+const LatencyStats& Campus::getJourneyTimes() const {
+    return journeyTimes;
+}
@@ -0,0 +1,111 @@
+#ifndef CAMPUS_H
+#define CAMPUS_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Building.h"
+#include "LatencyStats.h"
+#include "SimClock.h"
+#include "TrafficGenerator.h"
+
+// Many towers, each served by several banks of cars. A bank serves some of
+// its tower's floors, usually a lobby plus a zone such as "1,21-40", and
+// banks meet at shared lobbies and sky lobbies. A passenger whose origin
+// and destination no single bank serves rides to a transfer floor, walks
+// over to the next bank and calls a car again.
+//
+// Every bank is its own Building. Banks only interact through transfers,
+// and a transfer takes at least the walk time, so the banks are split
+// into shards that each run on their own thread through windows of that
+// length. Transferring passengers are handed over at the window
+// boundaries. The results are the same for any number of threads.
+class Campus {
+public:
+    struct Tower {
+        std::string name;
+        int numFloors;
+        TrafficGenerator::Pattern pattern;
+        double passengersPerHour;
+    };
+    
+    struct Bank {
+        std::string name;
+        int tower;               // Index into Layout::towers
+        int numElevators;
+        int capacity;
+        std::vector<int> floors; // Tower floors served, ascending
+    };
+    
+    // A campus file has one entry per line; '#' starts a comment:
+    //
+    //   transfer_time=30
+    //   tower <name> <floors> <traffic pattern> <passengers per hour>
+    //   bank <tower> <name> <elevators> <capacity> <floors, e.g. 1,21-40>
+    struct Layout {
+        std::vector<Tower> towers;
+        std::vector<Bank> banks;
+        double transferTime = 30.0; // Seconds to walk from one bank to another
+        
+        // Throws std::runtime_error naming the file and line of the first bad
+        // entry, or what is wrong with the layout as a whole
+        static Layout load(const std::string& path);
+        
+        // Throws std::invalid_argument unless every floor of every tower can
+        // be reached from every other floor
+        void validate() const;
+    };
+    
+    Campus(const Layout& layout, std::uint64_t seed);
+    
+    // Throws std::invalid_argument for an unknown strategy
+    void setDispatchStrategy(const std::string& name);
+    
+    // Generate arrivals until endTime, then carry on until every journey
+    // is over. Zero threads uses every core.
+    void run(SimTime endTime, int threads);
+    
+    const Layout& getLayout() const;
+    const Building& getBank(int index) const;
+    int getNumBanks() const;
+    int getShardCount() const; // Shards of the last run
+    SimTime getTime() const;
+    
+    // Journeys from origin to final destination, across every bank ridden
+    long getJourneysStarted() const;
+    long getJourneysCompleted() const;
+    long getTransfers() const;
+    const LatencyStats& getJourneyTimes() const; // Door to door, including transfers
+    
+private:
+    struct Journey {
+        int tower;
+        int destination;
+        SimTime start;
+    };
+    
+    Layout layout;
+    std::vector<std::unique_ptr<Building>> banks;
+    std::vector<std::vector<int>> localFloors;  // Per bank, tower floor -> bank floor, 0 if not served
+    std::vector<std::vector<int>> towerBanks;   // Per tower, its banks
+    std::vector<std::unique_ptr<TrafficGenerator>> traffic; // Per tower
+    std::vector<TrafficGenerator::Trip> nextTrips;          // Per tower, drawn but not started
+    std::vector<Journey> journeys;
+    std::vector<Building::CompletedLeg> legBuffer;
+    long journeysCompleted;
+    long transfers;
+    LatencyStats journeyTimes;
+    SimTime now;
+    int shardCount;
+    
+    // Bank to ride first, and where to leave it, on a route with the fewest
+    // changes; false if no route exists
+    bool planLeg(int tower, int from, int to, int& bank, int& exit) const;
+    void startLeg(int journey, int from, SimTime time);
+    void startArrivals(SimTime windowEnd, SimTime endTime);
+    void handOverTransfers();
+    bool hasPendingEvents() const;
+};
+
+#endif // CAMPUS_H
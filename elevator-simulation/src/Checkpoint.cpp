@@ -0,0 +1,68 @@
+#include "Checkpoint.h"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include "BinaryStream.h"
+
+namespace {
+const char MAGIC[4] = {'E', 'L', 'V', 'S'};
+}
+
+void Checkpoint::save(std::ostream& out, const Building& building, const TrafficGenerator* traffic) {
+    BinaryWriter writer(out);
+    writer.writeBytes(MAGIC, sizeof(MAGIC));
+    writer.writeUInt32(VERSION);
+    building.save(writer);
+    writer.writeBool(traffic != nullptr);
+    if (traffic) {
+        traffic->save(writer);
+    }
+}
+
+Checkpoint Checkpoint::restore(std::istream& in) {
+    BinaryReader reader(in);
+    char magic[4];
+    reader.readBytes(magic, sizeof(magic));
+    if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not a simulation snapshot");
+    }
+    std::uint32_t version = reader.readUInt32();
+    if (version != VERSION) {
+        throw std::runtime_error("Unsupported snapshot version " + std::to_string(version));
+    }
+    
+    Checkpoint checkpoint;
+    checkpoint.building = Building::restore(reader);
+    if (reader.readBool()) {
+        checkpoint.traffic = TrafficGenerator::restore(reader, checkpoint.building->getNumFloors());
+    }
+    return checkpoint;
+}
+
+void Checkpoint::saveFile(const std::string& path, const Building& building, const TrafficGenerator* traffic) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Could not create snapshot file: " + path);
+    }
+    save(out, building, traffic);
+}
+
+Checkpoint Checkpoint::restoreFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Could not open snapshot file: " + path);
+    }
+    return restore(in);
+}
+
+std::string Checkpoint::toBytes(const Building& building, const TrafficGenerator* traffic) {
+    std::ostringstream out(std::ios::binary);
+    save(out, building, traffic);
+    return out.str();
+}
+
+Checkpoint Checkpoint::fromBytes(const std::string& bytes) {
+    std::istringstream in(bytes, std::ios::binary);
+    return restore(in);
+}
@@ -0,0 +1,34 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include "Building.h"
+#include "TrafficGenerator.h"
+
+// A saved simulation: the building and, optionally, the traffic generator
+// feeding it, so a restored run draws the same future passengers.
+//
+// File format: the magic "ELVS", a little-endian uint32 version, the
+// building state, a flag byte and, if set, the traffic generator state.
+// Snapshots are only read back by the same version of the simulation.
+struct Checkpoint {
+    static const std::uint32_t VERSION = 7;
+    
+    std::unique_ptr<Building> building;
+    std::unique_ptr<TrafficGenerator> traffic; // Null if none was saved
+    
+    static void save(std::ostream& out, const Building& building, const TrafficGenerator* traffic);
+    static Checkpoint restore(std::istream& in);
+    
+    static void saveFile(const std::string& path, const Building& building, const TrafficGenerator* traffic);
+    static Checkpoint restoreFile(const std::string& path);
+    
+    // In-memory copies, for forking many runs from one warmed-up state
+    static std::string toBytes(const Building& building, const TrafficGenerator* traffic);
+    static Checkpoint fromBytes(const std::string& bytes);
+};
+
+#endif // CHECKPOINT_H
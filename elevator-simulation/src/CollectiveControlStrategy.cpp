@@ -0,0 +1,10 @@
+#include "CollectiveControlStrategy.h"
+
+const char* CollectiveControlStrategy::getName() const {
+    return "collective";
+}
+
+double CollectiveControlStrategy::cost(const Request& request, const Elevator& elevator,
+                                       int /*numFloors*/, int /*numElevators*/) const {
+    return estimateSweep(request, elevator).floors;
+}
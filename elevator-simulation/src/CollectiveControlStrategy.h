@@ -0,0 +1,18 @@
+#ifndef COLLECTIVECONTROLSTRATEGY_H
+#define COLLECTIVECONTROLSTRATEGY_H
+
+#include "DispatchStrategy.h"
+
+// Collective control (LOOK): cars keep sweeping in their direction and pick
+// up calls on the way. The call goes to the car with the shortest sweep
+// distance to it.
+class CollectiveControlStrategy : public DispatchStrategy {
+public:
+    const char* getName() const override;
+    
+protected:
+    double cost(const Request& request, const Elevator& elevator,
+                int numFloors, int numElevators) const override;
+};
+
+#endif // COLLECTIVECONTROLSTRATEGY_H
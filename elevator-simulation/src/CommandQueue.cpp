@@ -0,0 +1,26 @@
+#include "CommandQueue.h"
+
+CommandQueue::CommandQueue() : head(0), tail(0) {
+}
+
+bool CommandQueue::push(const SimCommand& command) {
+    size_t slot = tail.load(std::memory_order_relaxed);
+    if (slot - head.load(std::memory_order_acquire) >= CAPACITY) {
+        return false;
+    }
+    
+    ring[slot % CAPACITY] = command;
+    tail.store(slot + 1, std::memory_order_release);
+    return true;
+}
+
+bool CommandQueue::pop(SimCommand& command) {
+    size_t slot = head.load(std::memory_order_relaxed);
+    if (slot == tail.load(std::memory_order_acquire)) {
+        return false;
+    }
+    
+    command = ring[slot % CAPACITY];
+    head.store(slot + 1, std::memory_order_release);
+    return true;
+}
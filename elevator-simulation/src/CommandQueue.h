@@ -0,0 +1,36 @@
+#ifndef COMMANDQUEUE_H
+#define COMMANDQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include "Request.h"
+
+// User input handed from the view to the simulation thread
+struct SimCommand {
+    enum Type { HALL_CALL, CAR_CALL, OPEN_DOORS };
+    
+    Type type;
+    int floor;
+    int elevator;
+    Request::Direction direction;
+};
+
+// Lock-free single-producer, single-consumer ring buffer of commands. The
+// render thread pushes and the simulation thread pops; each side only
+// writes its own index, so neither ever blocks.
+class CommandQueue {
+public:
+    static const size_t CAPACITY = 256;
+    
+    CommandQueue();
+    
+    bool push(const SimCommand& command); // False if the queue is full
+    bool pop(SimCommand& command);        // False if the queue is empty
+    
+private:
+    SimCommand ring[CAPACITY];
+    alignas(64) std::atomic<size_t> head; // Next slot to pop
+    alignas(64) std::atomic<size_t> tail; // Next slot to push
+};
+
+#endif // COMMANDQUEUE_H
@@ -0,0 +1,235 @@
+#include "DestinationDispatcher.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include "DispatchStrategy.h"
+
+namespace {
+const int IMPROVEMENT_PASSES = 3;
+const double AGING_TIME = 30.0; // Seconds of waiting worth one more member of a group
+const double UNAVAILABLE = std::numeric_limits<double>::infinity();
+
+Request::Direction directionOf(const DestinationDispatcher::Call& call) {
+    return (call.destination > call.origin) ? Request::UP : Request::DOWN;
+}
+}
+
+DestinationDispatcher::DestinationDispatcher(SimTime batchWindow, int numFloors)
+    : batchWindow(batchWindow), numFloors(numFloors) {
+    if (batchWindow <= 0) {
+        throw std::invalid_argument("Batch window must be positive");
+    }
+}
+
+void DestinationDispatcher::setBatchWindow(SimTime window) {
+    if (window <= 0) {
+        throw std::invalid_argument("Batch window must be positive");
+    }
+    batchWindow = window;
+}
+
+SimTime DestinationDispatcher::getBatchWindow() const {
+    return batchWindow;
+}
+
+bool DestinationDispatcher::addCall(const Call& call) {
+    pending.push_back(call);
+    return pending.size() == 1;
+}
+
+bool DestinationDispatcher::hasPendingCalls() const {
+    return !pending.empty();
+}
+
+const std::vector<DestinationDispatcher::Call>& DestinationDispatcher::getPendingCalls() const {
+    return pending;
+}
+
+void DestinationDispatcher::clear() {
+    pending.clear();
+}
+
+void DestinationDispatcher::assignBatch(SimTime now, const std::vector<Elevator>& elevators,
+                                        const std::vector<int>& committed, std::vector<Assignment>& assignments) {
+    int numCalls = pending.size();
+    int numCars = elevators.size();
+    carOf.assign(numCalls, -1);
+    taken.assign(numCars, 0);
+    stopUses.assign(numCars * (numFloors + 1), 0);
+    
+    // Largest origin/destination groups first, so that they claim cars
+    // before stragglers spread stops over the fleet. Waiting counts as
+    // extra members, so a small group cannot be passed over for ever.
+    order.resize(numCalls);
+    for (int i = 0; i < numCalls; i++) {
+        order[i] = i;
+    }
+    auto sameTrip = [this](int a, int b) {
+        return pending[a].origin == pending[b].origin && pending[a].destination == pending[b].destination;
+    };
+    auto byTrip = [this](int a, int b) {
+        if (pending[a].origin != pending[b].origin) {
+            return pending[a].origin < pending[b].origin;
+        }
+        if (pending[a].destination != pending[b].destination) {
+            return pending[a].destination < pending[b].destination;
+        }
+        return a < b;
+    };
+    std::sort(order.begin(), order.end(), byTrip);
+    priorities.resize(numCalls);
+    for (int first = 0; first < numCalls;) {
+        int last = first;
+        SimTime oldest = pending[order[first]].time;
+        while (last + 1 < numCalls && sameTrip(order[first], order[last + 1])) {
+            last++;
+            oldest = std::min(oldest, pending[order[last]].time);
+        }
+        double priority = (last - first + 1) + SimClock::toSeconds(now - oldest) / AGING_TIME;
+        for (int i = first; i <= last; i++) {
+            priorities[order[i]] = priority;
+        }
+        first = last + 1;
+    }
+    // A full comparison rather than a stable sort, which would allocate
+    std::sort(order.begin(), order.end(), [this, &byTrip](int a, int b) {
+        if (priorities[a] != priorities[b]) {
+            return priorities[a] > priorities[b];
+        }
+        return byTrip(a, b);
+    });
+    
+    auto bestCar = [&](int call) {
+        int best = -1;
+        double bestCost = UNAVAILABLE;
+        for (int car = 0; car < numCars; car++) {
+            double carCost = cost(elevators[car], committed[car] + taken[car], pending[call]);
+            if (carCost < bestCost) {
+                best = car;
+                bestCost = carCost;
+            }
+        }
+        return std::make_pair(best, bestCost);
+    };
+    
+    for (int call : order) {
+        int car = bestCar(call).first;
+        if (car >= 0) {
+            place(call, car, 1);
+        }
+    }
+    
+    // Move single calls while that lowers their cost; each move only ever
+    // lowers the total, so this settles quickly
+    for (int pass = 0; pass < IMPROVEMENT_PASSES; pass++) {
+        bool moved = false;
+        for (int call : order) {
+            int current = carOf[call];
+            if (current < 0) {
+                continue;
+            }
+            place(call, current, -1);
+            double stayCost = cost(elevators[current], committed[current] + taken[current], pending[call]);
+            std::pair<int, double> best = bestCar(call);
+            if (best.first != current && best.second + 1e-9 < stayCost) {
+                place(call, best.first, 1);
+                moved = true;
+            } else {
+                place(call, current, 1);
+            }
+        }
+        if (!moved) {
+            break;
+        }
+    }
+    
+    // Hand out the placed calls and keep the rest for the next batch
+    size_t kept = 0;
+    for (int call = 0; call < numCalls; call++) {
+        if (carOf[call] >= 0) {
+            assignments.push_back({pending[call].passenger, carOf[call]});
+        } else {
+            pending[kept++] = pending[call];
+        }
+    }
+    pending.resize(kept);
+}
+
+double DestinationDispatcher::cost(const Elevator& elevator, int committed, const Call& call) const {
+    int riders = elevator.getLoad() + committed;
+    if (riders + 1 > elevator.getCapacity()) {
+        return UNAVAILABLE;
+    }
+    
+    double total = SimClock::toSeconds(reachTime(elevator, call));
+    
+    double stopDelay = SimClock::toSeconds(elevator.getDoorCycleTime() + elevator.getTravelTime(1));
+    bool waitingThere = !elevator.isMoving() && elevator.getCurrentFloor() == call.origin;
+    if (!waitingThere && !stopsAt(elevator, call.origin)) {
+        total += stopDelay * riders;
+    }
+    if (!stopsAt(elevator, call.destination)) {
+        total += stopDelay * (riders + 1);
+    }
+    return total;
+}
+
+SimTime DestinationDispatcher::reachTime(const Elevator& elevator, const Call& call) {
+    // Same reach estimate as the ETA strategy
+    Request pickup(call.origin, directionOf(call));
+    DispatchStrategy::Sweep sweep = DispatchStrategy::estimateSweep(pickup, elevator);
+    return elevator.getBusyTime()
+         + elevator.getTravelTime(sweep.floors, sweep.stops)
+         + sweep.stops * elevator.getDoorCycleTime();
+}
+
+bool DestinationDispatcher::windowDelays(const Call& call, const std::vector<Elevator>& elevators,
+                                         const std::vector<int>& committed) const {
+    for (const Elevator& elevator : elevators) {
+        if (elevator.getLoad() + committed[elevator.getId()] < elevator.getCapacity() &&
+            reachTime(elevator, call) < batchWindow) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DestinationDispatcher::stopsAt(const Elevator& elevator, int floor) const {
+    return stopUses[elevator.getId() * (numFloors + 1) + floor] > 0 || elevator.countStopsBetween(floor, floor) > 0;
+}
+
+void DestinationDispatcher::place(int call, int car, int delta) {
+    int* floors = &stopUses[car * (numFloors + 1)];
+    floors[pending[call].origin] += delta;
+    floors[pending[call].destination] += delta;
+    taken[car] += delta;
+    carOf[call] = (delta > 0) ? car : -1;
+}
+
+void DestinationDispatcher::save(BinaryWriter& out) const {
+    out.writeInt64(batchWindow);
+    out.writeUInt64(pending.size());
+    for (const auto& call : pending) {
+        out.writeInt(call.passenger);
+        out.writeInt(call.origin);
+        out.writeInt(call.destination);
+        out.writeInt64(call.time);
+    }
+}
+
+void DestinationDispatcher::restore(BinaryReader& in) {
+    setBatchWindow(in.readInt64());
+    size_t count = in.readCount(1u << 30);
+    pending.clear();
+    for (size_t i = 0; i < count; i++) {
+        Call call;
+        call.passenger = in.readInt();
+        call.origin = in.readInt();
+        call.destination = in.readInt();
+        call.time = in.readInt64();
+        if (call.origin < 1 || call.origin > numFloors || call.destination < 1 || call.destination > numFloors) {
+            throw std::runtime_error("Snapshot is corrupt: destination call outside the building");
+        }
+        pending.push_back(call);
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef DESTINATIONDISPATCHER_H
+#define DESTINATIONDISPATCHER_H
+
+#include <vector>
+#include "BinaryStream.h"
+#include "Elevator.h"
+#include "SimClock.h"
+
+// Destination control: passengers key in their destination on a panel at
+// their floor and are told which car to take. Calls are collected over a
+// short batching window and then assigned together, so that each car is
+// given passengers bound for the same or nearby floors. Fewer stops per
+// round trip is where destination control gains its up-peak handling
+// capacity. A call with nothing to group with at its floor is not held for
+// the window if a car could reach it sooner.
+//
+// Assigning a batch is a grouping problem: a car that already stops at a
+// passenger's destination takes them almost for free, while a new stop
+// delays everyone on board. Calls are placed greedily, largest
+// origin/destination group first, each on the car with the lowest
+// marginal cost; every 30 s a call has waited counts as one more member
+// of its group, so small groups are not passed over for ever. A few
+// improvement passes then move single calls to another car while that
+// lowers the total. A call's cost on a car is the time the car needs to
+// reach the caller, plus one stop's delay (a door cycle and a run from
+// rest) for every rider of each stop the call adds. A car never takes
+// more passengers than it has room for.
+class DestinationDispatcher {
+public:
+    struct Call {
+        int passenger;
+        int origin;
+        int destination;
+        SimTime time; // When the passenger first keyed the destination in
+    };
+    
+    struct Assignment {
+        int passenger;
+        int car;
+    };
+    
+    DestinationDispatcher(SimTime batchWindow, int numFloors);
+    
+    void setBatchWindow(SimTime batchWindow);
+    SimTime getBatchWindow() const;
+    
+    // Queue a call for the next batch; true if it opened the batch, so the
+    // caller should assign the batch one window from now
+    bool addCall(const Call& call);
+    bool hasPendingCalls() const;
+    const std::vector<Call>& getPendingCalls() const;
+    void clear(); // Drop every pending call
+    
+    // Assign the batch, appending one assignment per call that a car has
+    // room for. committed[i] counts passengers assigned to car i earlier
+    // who have not boarded yet. Calls that did not fit stay queued.
+    void assignBatch(SimTime now, const std::vector<Elevator>& elevators, const std::vector<int>& committed,
+                     std::vector<Assignment>& assignments);
+    
+    // True if a car with room could reach the caller within one batch
+    // window, so that holding the call for the window would delay its
+    // pickup
+    bool windowDelays(const Call& call, const std::vector<Elevator>& elevators,
+                      const std::vector<int>& committed) const;
+    
+    void save(BinaryWriter& out) const;
+    void restore(BinaryReader& in);
+    
+private:
+    SimTime batchWindow;
+    int numFloors;
+    std::vector<Call> pending;
+    
+    // Scratch reused from batch to batch
+    std::vector<int> order;      // Calls in the order they are placed
+    std::vector<double> priorities; // Per call, size of its origin/destination group plus its age
+    std::vector<int> carOf;      // Per call, -1 if not placed
+    std::vector<int> taken;      // Per car, calls placed on it in this batch
+    std::vector<int> stopUses;   // Per car and floor, placed calls that stop there
+    
+    static SimTime reachTime(const Elevator& elevator, const Call& call);
+    double cost(const Elevator& elevator, int committed, const Call& call) const;
+    bool stopsAt(const Elevator& elevator, int floor) const;
+    void place(int call, int car, int delta);
+};
+
+#endif // DESTINATIONDISPATCHER_H
@@ -0,0 +1,155 @@
+#include "DispatchKernel.h"
+#include <cstdlib>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DISPATCH_KERNEL_AVX2 1
+#endif
+
+const float DispatchKernel::FULL_CAR_COST = std::numeric_limits<float>::infinity();
+
+namespace {
+
+// Score one car; shared by the scalar path, the vector tail and single cars
+float carCost(int position, int direction, int stops, int load, int capacity, const Request& request,
+              int numFloors, float secondsPerFloor, float secondsPerStop, float loadPenalty) {
+    const int call = request.getFloor();
+    const int callDirection = request.getDirection();
+    
+    // Mirror the coordinates of a car heading down so every car sweeps
+    // upwards from 'from' to 'end', then back down to 'begin'
+    bool down = direction == Request::DOWN;
+    int from = down ? -position : position;
+    int target = down ? -call : call;
+    int end = down ? -1 : numFloors;
+    int begin = down ? -numFloors : 1;
+    
+    bool idle = direction == Request::NONE || stops == 0;
+    bool sameDirection = callDirection == direction || callDirection == Request::NONE;
+    int ahead = target - from;
+    int reverse = (end - from) + (end - target);
+    int loop = (end - from) + (end - begin) + (target - begin);
+    int moving = sameDirection ? (ahead >= 0 ? ahead : loop) : reverse;
+    int floors = idle ? std::abs(call - position) : moving;
+    
+    float loadRatio = static_cast<float>(load) / static_cast<float>(capacity);
+    float time = (static_cast<float>(floors) * secondsPerFloor + static_cast<float>(stops) * secondsPerStop)
+                 + loadRatio * loadPenalty;
+    return (load >= capacity) ? DispatchKernel::FULL_CAR_COST : time;
+}
+
+// Score cars [first, last)
+void estimateRange(const FleetState& fleet, const Request& request, float* costs, int first, int last) {
+    for (int car = first; car < last; car++) {
+        costs[car] = carCost(fleet.targetFloor[car], fleet.direction[car], fleet.stopCount[car], fleet.load[car],
+                             fleet.capacity[car], request, fleet.numFloors, fleet.secondsPerFloor[car],
+                             fleet.secondsPerStop[car], fleet.loadPenalty[car]);
+    }
+}
+
+#ifdef DISPATCH_KERNEL_AVX2
+__attribute__((target("avx2")))
+void estimateAvx2(const FleetState& fleet, const Request& request, float* costs) {
+    const int numCars = fleet.size();
+    const __m256i call = _mm256_set1_epi32(request.getFloor());
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i allOnes = _mm256_set1_epi32(-1);
+    const __m256i downDirection = _mm256_set1_epi32(Request::DOWN);
+    const __m256i noDirection = _mm256_set1_epi32(Request::NONE);
+    const __m256i topFloor = _mm256_set1_epi32(fleet.numFloors);
+    const __m256i negativeTopFloor = _mm256_set1_epi32(-fleet.numFloors);
+    const __m256 fullCost = _mm256_set1_ps(DispatchKernel::FULL_CAR_COST);
+    
+    // A call with no direction matches every car's direction
+    const int callDirection = request.getDirection();
+    const __m256i callDirectionVector = _mm256_set1_epi32(callDirection);
+    const __m256i anyDirection = (callDirection == Request::NONE) ? allOnes : _mm256_setzero_si256();
+    
+    int car = 0;
+    for (; car + 8 <= numCars; car += 8) {
+        __m256i position = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&fleet.targetFloor[car]));
+        __m256i stops = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&fleet.stopCount[car]));
+        __m256i load = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&fleet.load[car]));
+        __m256i capacity = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&fleet.capacity[car]));
+        __m256i direction = _mm256_cvtepu8_epi32(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&fleet.direction[car])));
+        __m256 secondsPerFloor = _mm256_loadu_ps(&fleet.secondsPerFloor[car]);
+        __m256 secondsPerStop = _mm256_loadu_ps(&fleet.secondsPerStop[car]);
+        __m256 loadPenalty = _mm256_loadu_ps(&fleet.loadPenalty[car]);
+        
+        // Lane masks are all ones where true; negation is (x ^ mask) - mask
+        __m256i down = _mm256_cmpeq_epi32(direction, downDirection);
+        __m256i from = _mm256_sub_epi32(_mm256_xor_si256(position, down), down);
+        __m256i target = _mm256_sub_epi32(_mm256_xor_si256(call, down), down);
+        __m256i end = _mm256_blendv_epi8(topFloor, allOnes, down);
+        __m256i begin = _mm256_blendv_epi8(one, negativeTopFloor, down);
+        
+        __m256i idle = _mm256_or_si256(_mm256_cmpeq_epi32(direction, noDirection),
+                                       _mm256_cmpeq_epi32(stops, _mm256_setzero_si256()));
+        __m256i sameDirection = _mm256_or_si256(_mm256_cmpeq_epi32(direction, callDirectionVector), anyDirection);
+        __m256i ahead = _mm256_sub_epi32(target, from);
+        __m256i toEnd = _mm256_sub_epi32(end, from);
+        __m256i reverse = _mm256_add_epi32(toEnd, _mm256_sub_epi32(end, target));
+        __m256i loop = _mm256_add_epi32(_mm256_add_epi32(toEnd, _mm256_sub_epi32(end, begin)),
+                                        _mm256_sub_epi32(target, begin));
+        __m256i isAhead = _mm256_cmpgt_epi32(ahead, allOnes);
+        __m256i moving = _mm256_blendv_epi8(reverse, _mm256_blendv_epi8(loop, ahead, isAhead), sameDirection);
+        __m256i floors = _mm256_blendv_epi8(moving, _mm256_abs_epi32(_mm256_sub_epi32(call, position)), idle);
+        
+        __m256 loadRatio = _mm256_div_ps(_mm256_cvtepi32_ps(load), _mm256_cvtepi32_ps(capacity));
+        __m256 time = _mm256_add_ps(
+            _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(floors), secondsPerFloor),
+                          _mm256_mul_ps(_mm256_cvtepi32_ps(stops), secondsPerStop)),
+            _mm256_mul_ps(loadRatio, loadPenalty));
+        __m256i full = _mm256_xor_si256(_mm256_cmpgt_epi32(capacity, load), allOnes);
+        _mm256_storeu_ps(&costs[car], _mm256_blendv_ps(time, fullCost, _mm256_castsi256_ps(full)));
+    }
+    
+    estimateRange(fleet, request, costs, car, numCars);
+}
+#endif
+}
+
+DispatchKernel::Timing DispatchKernel::fit(const Elevator& elevator, int numFloors) {
+    int span = (numFloors > 1) ? numFloors - 1 : 1;
+    double oneFloor = SimClock::toSeconds(elevator.getTravelTime(1));
+    double perFloor = (span > 1) ? (SimClock::toSeconds(elevator.getTravelTime(span)) - oneFloor) / (span - 1) : oneFloor;
+    double doorCycle = SimClock::toSeconds(elevator.getDoorCycleTime());
+    
+    Timing timing;
+    timing.secondsPerFloor = static_cast<float>(perFloor);
+    timing.secondsPerStop = static_cast<float>(oneFloor - perFloor + doorCycle);
+    timing.loadPenalty = static_cast<float>(doorCycle);
+    return timing;
+}
+
+void DispatchKernel::estimate(const FleetState& fleet, const Request& request, float* costs) {
+#ifdef DISPATCH_KERNEL_AVX2
+    if (hasSimd()) {
+        estimateAvx2(fleet, request, costs);
+        return;
+    }
+#endif
+    estimateScalar(fleet, request, costs);
+}
+
+void DispatchKernel::estimateScalar(const FleetState& fleet, const Request& request, float* costs) {
+    estimateRange(fleet, request, costs, 0, fleet.size());
+}
+
+float DispatchKernel::estimateCar(const Elevator& elevator, const Request& request, int numFloors) {
+    Timing timing = fit(elevator, numFloors);
+    return carCost(elevator.getTargetFloor(), elevator.getCurrentDirection(), elevator.getStopCount(),
+                   elevator.getLoad(), elevator.getCapacity(), request, numFloors, timing.secondsPerFloor,
+                   timing.secondsPerStop, timing.loadPenalty);
+}
+
+bool DispatchKernel::hasSimd() {
+#ifdef DISPATCH_KERNEL_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,47 @@
+#ifndef DISPATCHKERNEL_H
+#define DISPATCHKERNEL_H
+
+#include "Elevator.h"
+#include "FleetState.h"
+#include "Request.h"
+
+// Estimates the time for every car in the fleet to serve one hall call, in
+// a single branch-free pass over the fleet arrays. Each car is scored from
+// its position, direction, queued-stop count and load only:
+//
+//   time = floors * secondsPerFloor + stops * secondsPerStop
+//        + (load / capacity) * loadPenalty
+//
+// where floors is the distance the car covers before reaching the call
+// under SCAN (sweep to the end of the shaft before reversing), and the
+// three rates are the car's own timing fit from the fleet arrays. Full
+// cars score +infinity. On x86 CPUs with AVX2 eight cars are scored per
+// instruction; elsewhere a scalar loop computes the same values.
+class DispatchKernel {
+public:
+    struct Timing {
+        float secondsPerFloor;
+        float secondsPerStop;
+        float loadPenalty;
+    };
+    
+    // Linear fit of a car's timing in a building of numFloors: the run time
+    // grows by a fixed amount per floor between a one-floor and a
+    // full-height run, and every stop adds the rest of a one-floor run
+    // plus a door cycle
+    static Timing fit(const Elevator& elevator, int numFloors);
+    
+    // Writes one cost per car into costs[0 .. fleet.size())
+    static void estimate(const FleetState& fleet, const Request& request, float* costs);
+    static void estimateScalar(const FleetState& fleet, const Request& request, float* costs);
+    
+    // The same estimate for one car, from its accessors and a fresh fit
+    static float estimateCar(const Elevator& elevator, const Request& request, int numFloors);
+    
+    static const float FULL_CAR_COST;
+    
+    // True if estimate() uses the AVX2 path on this machine
+    static bool hasSimd();
+};
+
+#endif // DISPATCHKERNEL_H
@@ -0,0 +1,159 @@
+#include "DispatchStrategy.h"
+#include <algorithm>
+#include <cstdlib>
+#include "CollectiveControlStrategy.h"
+#include "EtaStrategy.h"
+#include "FastEtaStrategy.h"
+#include "NearestCarStrategy.h"
+#include "ZoningStrategy.h"
+
+namespace {
+const double AGING_TIME = 30.0; // Seconds of waiting worth one more delayed call
+}
+
+int DispatchStrategy::selectElevator(const Request& request, const std::vector<Elevator>& elevators,
+                                     const FleetState& fleet, const std::vector<Floor>& floors, SimTime now,
+                                     float*) const {
+    int numFloors = floors.size();
+    int numElevators = elevators.size();
+    int best = -1;
+    double bestCost = 0.0;
+    
+    for (int i = 0; i < numElevators; i++) {
+        // Full cars cannot pick anyone up
+        if (fleet.load[i] >= fleet.capacity[i]) {
+            continue;
+        }
+        
+        // Ties go to the lowest-numbered car. The call age term is never
+        // negative, so it is only worked out for cars that can still win.
+        double carCost = cost(request, elevators[i], numFloors, numElevators);
+        if (energyWeight > 0.0) {
+            carCost += energyCost(request, elevators[i]);
+        }
+        if (best >= 0 && carCost >= bestCost) {
+            continue;
+        }
+        carCost += callAgeCost(request, elevators[i], floors, now);
+        if (best < 0 || carCost < bestCost) {
+            best = i;
+            bestCost = carCost;
+        }
+    }
+    
+    return best;
+}
+
+void DispatchStrategy::setEnergyWeight(double secondsPerKWh) {
+    energyWeight = std::max(secondsPerKWh, 0.0);
+}
+
+double DispatchStrategy::getEnergyWeight() const {
+    return energyWeight;
+}
+
+double DispatchStrategy::energyCost(const Request& request, const Elevator& elevator) const {
+    return energyWeight * EnergyModel::toKWh(elevator.estimateRunEnergy(elevator.getTargetFloor(), request.getFloor()));
+}
+
+double DispatchStrategy::callAgeCost(const Request&, const Elevator&,
+                                     const std::vector<Floor>&, SimTime) const {
+    return 0.0;
+}
+
+double DispatchStrategy::delayedCallCost(const Request& request, const Elevator& elevator,
+                                         const std::vector<Floor>& floors, SimTime now) {
+    // Only a new stop ahead of the car on its current sweep holds up the
+    // stops beyond it; a call it serves later waits behind them instead
+    Request::Direction carDirection = elevator.getCurrentDirection();
+    int call = request.getFloor();
+    if (elevator.getStopCount() == 0 || carDirection == Request::NONE || elevator.countStopsBetween(call, call) > 0) {
+        return 0.0;
+    }
+    bool up = carDirection == Request::UP;
+    bool sameDirection = request.getDirection() == carDirection || request.getDirection() == Request::NONE;
+    if (!sameDirection || (up ? call < elevator.getTargetFloor() : call > elevator.getTargetFloor())) {
+        return 0.0;
+    }
+    
+    SimTime waited = 0;
+    int floor = up ? elevator.getNextStopAtOrAbove(call + 1) : elevator.getNextStopAtOrBelow(call - 1);
+    while (floor != 0) {
+        const Floor& landing = floors[floor - 1];
+        waited += landing.getCallAge(Request::UP, now) + landing.getCallAge(Request::DOWN, now);
+        floor = up ? elevator.getNextStopAtOrAbove(floor + 1) : elevator.getNextStopAtOrBelow(floor - 1);
+    }
+    
+    // Each of those calls waits at least one more door cycle
+    return SimClock::toSeconds(elevator.getDoorCycleTime()) * SimClock::toSeconds(waited) / AGING_TIME;
+}
+
+std::unique_ptr<DispatchStrategy> DispatchStrategy::create(const std::string& name) {
+    if (name == "nearest" || name == "proximity") {
+        return std::unique_ptr<DispatchStrategy>(new NearestCarStrategy());
+    }
+    if (name == "collective" || name == "scan" || name == "look" || name == "direction") {
+        return std::unique_ptr<DispatchStrategy>(new CollectiveControlStrategy());
+    }
+    if (name == "eta") {
+        return std::unique_ptr<DispatchStrategy>(new EtaStrategy());
+    }
+    if (name == "fast-eta" || name == "simd") {
+        return std::unique_ptr<DispatchStrategy>(new FastEtaStrategy());
+    }
+    if (name == "zoning") {
+        return std::unique_ptr<DispatchStrategy>(new ZoningStrategy());
+    }
+    return nullptr;
+}
+
+const char* DispatchStrategy::getAvailableNames() {
+    return "nearest (proximity), collective (scan, look, direction), eta, fast-eta (simd), zoning";
+}
+
+DispatchStrategy::Sweep DispatchStrategy::estimateSweep(const Request& request, const Elevator& elevator) {
+    Sweep sweep = {0, 0};
+    
+    // A car with nothing queued goes straight to the call
+    Request::Direction carDirection = elevator.getCurrentDirection();
+    if (elevator.getStopCount() == 0 || carDirection == Request::NONE) {
+        sweep.floors = std::abs(request.getFloor() - elevator.getTargetFloor());
+        return sweep;
+    }
+    
+    // Work in coordinates where the car travels upwards; sign flips them for
+    // a car heading down
+    int sign = (carDirection == Request::UP) ? 1 : -1;
+    int from = sign * elevator.getTargetFloor();
+    int call = sign * request.getFloor();
+    int farthest = std::max(from, sign * (sign > 0 ? elevator.getHighestStop() : elevator.getLowestStop()));
+    int nearest = sign * (sign > 0 ? elevator.getLowestStop() : elevator.getHighestStop());
+    bool sameDirection = request.getDirection() == carDirection || request.getDirection() == Request::NONE;
+    
+    auto stopsIn = [&elevator, sign](int a, int b) {
+        if (a > b) {
+            return 0;
+        }
+        return elevator.countStopsBetween(std::min(sign * a, sign * b), std::max(sign * a, sign * b));
+    };
+    
+    if (sameDirection && call >= from) {
+        // Ahead of the car and in its direction: picked up on this sweep
+        sweep.floors = call - from;
+        sweep.stops = stopsIn(from, call - 1);
+    }
+    else if (!sameDirection) {
+        // Opposite direction: served after the car reverses
+        int turn = std::max(farthest, call);
+        sweep.floors = (turn - from) + (turn - call);
+        sweep.stops = stopsIn(from, turn) + stopsIn(call + 1, from - 1);
+    }
+    else {
+        // Behind the car in its direction: needs a full loop
+        int bottom = std::min(nearest, call);
+        sweep.floors = (farthest - from) + (farthest - bottom) + (call - bottom);
+        sweep.stops = elevator.getStopCount();
+    }
+    
+    return sweep;
+}
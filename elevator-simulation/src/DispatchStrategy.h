@@ -0,0 +1,74 @@
+#ifndef DISPATCHSTRATEGY_H
+#define DISPATCHSTRATEGY_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Elevator.h"
+#include "FleetState.h"
+#include "Floor.h"
+#include "Request.h"
+#include "SimClock.h"
+
+// Decides which car serves a hall call. Strategies score every car with a
+// cost function in a single pass over the fleet, so choosing a car for a
+// new call is O(cars) and never allocates.
+class DispatchStrategy {
+public:
+    virtual ~DispatchStrategy() {}
+    
+    virtual const char* getName() const = 0;
+    
+    // Returns the index of the car that should serve the call, or -1 if no
+    // car can take it (every car is full). The fleet holds the same cars'
+    // hot state as parallel arrays for strategies that scan it in bulk.
+    // The floors show every latched hall call and, through its call time,
+    // how long it has been waiting at time now. scratch is caller-owned
+    // space for one float per car, which strategies may overwrite, so a
+    // strategy keeps no per-call state of its own.
+    virtual int selectElevator(const Request& request, const std::vector<Elevator>& elevators,
+                               const FleetState& fleet, const std::vector<Floor>& floors, SimTime now,
+                               float* scratch) const;
+    
+    // Seconds of waiting worth one kWh. When positive, the estimated net
+    // energy of sending a car to the call is added to its cost, so cars
+    // whose run would regenerate are preferred over ones that draw power.
+    void setEnergyWeight(double secondsPerKWh);
+    double getEnergyWeight() const;
+    
+    // How far a car has to travel, and how many stops it makes on the way,
+    // before it can serve the call under collective (LOOK) control
+    struct Sweep {
+        int floors;
+        int stops;
+    };
+    static Sweep estimateSweep(const Request& request, const Elevator& elevator);
+    
+    // Create a strategy by name; returns nullptr for an unknown name
+    static std::unique_ptr<DispatchStrategy> create(const std::string& name);
+    static const char* getAvailableNames();
+    
+protected:
+    // Lower is better. Only called for cars that are not full.
+    virtual double cost(const Request& request, const Elevator& elevator,
+                        int numFloors, int numElevators) const = 0;
+    
+    // Energy term of the cost, in the same seconds as cost()
+    double energyCost(const Request& request, const Elevator& elevator) const;
+    
+    // Cost of the calls already latched at the floors; never negative, and
+    // none by default
+    virtual double callAgeCost(const Request& request, const Elevator& elevator,
+                               const std::vector<Floor>& floors, SimTime now) const;
+    
+    // Delay a new stop for the call adds to the hall calls the car answers
+    // after it on this sweep, weighted by how long each has waited, so a
+    // car on its way to an old call is spared extra stops. In seconds.
+    static double delayedCallCost(const Request& request, const Elevator& elevator,
+                                  const std::vector<Floor>& floors, SimTime now);
+                                  
+private:
+    double energyWeight = 0.0;
+};
+
+#endif // DISPATCHSTRATEGY_H
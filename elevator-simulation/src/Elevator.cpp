@@ -1,165 +1,591 @@
 #include "Elevator.h"
+#include "DispatchKernel.h"
+#include "EventTrace.h"
 #include "Request.h"
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
+#include <stdexcept>
 #include <vector>
 
-Elevator::Elevator(int id, int totalFloors) 
-    : id(id), currentFloor(1), moving(false), doorsOpenState(false), totalFloors(totalFloors),
-      direction(Request::NONE), movementProgress(0.0f), doorProgress(0.0f), targetFloor(1) {}
+Elevator::Params Elevator::defaultParams() {
+    Params params;
+    params.ratedSpeed = 2.5;
+    params.acceleration = 1.0;
+    params.jerk = 1.5;
+    params.floorHeight = 3.5;
+    params.doorOperationTime = SimClock::fromSeconds(1.0);
+    params.doorDwellTime = SimClock::fromSeconds(1.5);
+    params.energy = EnergyModel::defaultParams();
+    return params;
+}
+
+Elevator::Elevator(FleetState& fleet, std::vector<Floor>& floors, int capacity, const SimClock& clock,
+                   EventQueue& events) 
+    : fleet(&fleet), floors(&floors), id(fleet.addCar(capacity)), clock(&clock), events(&events), params(defaultParams()),
+      motion(params.ratedSpeed, params.acceleration, params.jerk), runMotion(motion), energyModel(params.energy), energy{0.0, 0.0, 0.0, 0.0}, standbySince(clock.now()),
+      eventGeneration(0), floorsTravelled(0), stopsServed(0), serviceTime(0), serviceSince(clock.now()) {
+    fleet.movementStart[id] = clock.now();
+    fleet.doorOpenedAt[id] = clock.now();
+    riders.reserve(capacity);
+    fitTiming();
+}
 
 void Elevator::moveToFloor(int floor) {
-    if (floor < 1 || floor > totalFloors || floor == currentFloor) {
+    if (floor < 1 || floor > fleet->numFloors || floor == fleet->currentFloor[id]) {
         return;
     }
     
-    targetFloor = floor;
-    moving = true;
-    direction = (targetFloor > currentFloor) ? Request::UP : Request::DOWN;
-    movementProgress = 0.0f;
-    movementClock.restart();
+    accrueService();
+    fleet->targetFloor[id] = floor;
+    fleet->moving[id] = true;
+    fleet->direction[id] = (floor > fleet->currentFloor[id]) ? Request::UP : Request::DOWN;
+    fleet->movementStart[id] = clock->now();
+    
+    // Freeze the profile for this run so a settings change cannot move a
+    // car that is already under way
+    runMotion = motion;
+    fleet->arrivalTime[id] = fleet->movementStart[id] + getTravelTime(std::abs(floor - fleet->currentFloor[id]));
+    scheduleEvent(fleet->arrivalTime[id], SimEvent::CAR_ARRIVAL);
+    TRACE_EVENT(clock->now(), EventTrace::CAR_DEPARTED, id, fleet->currentFloor[id]);
 }
 
 void Elevator::openDoors() {
-    if (!doorsOpenState) {
-        doorsOpenState = true;
-        doorProgress = 0.0f;
-        doorClock.restart();
-        doorTimer.restart(); // Make sure door timer is restarted when doors open
+    // Doors never open between floors
+    if (isMoving()) {
+        return;
+    }
+    
+    accrueService();
+    SimTime now = clock->now();
+    fleet->doorOpenedAt[id] = now; // Make sure door timer is restarted when doors open
+    answerHallCalls();
+    
+    if (getDoorState() == CLOSED || getDoorState() == CLOSING) {
+        fleet->doorState[id] = OPENING;
+        scheduleEvent(now + params.doorOperationTime, SimEvent::DOORS_OPENED);
+    }
+    else if (getDoorState() == OPEN) {
+        // Already open: extend the dwell
+        scheduleEvent(now + params.doorDwellTime, SimEvent::DOORS_CLOSE_TIMEOUT);
     }
 }
 
 void Elevator::closeDoors() {
-    if (doorsOpenState) {
-        doorsOpenState = false;
-        doorProgress = 0.0f;
-        doorClock.restart();
+    if (getDoorState() == OPENING || getDoorState() == OPEN) {
+        fleet->doorState[id] = CLOSING;
+        scheduleEvent(clock->now() + params.doorOperationTime, SimEvent::DOORS_CLOSED);
     }
 }
 
 void Elevator::addRequest(const Request& request) {
-    // Check if request is already in the queue
-    for (const auto& req : requests) {
-        if (req.getFloor() == request.getFloor()) {
-            return; // Already have a request for this floor
-        }
+    // A stationary car at the requested floor just (re)opens its doors
+    if (!isMoving() && request.getFloor() == fleet->currentFloor[id]) {
+        openDoors();
+        return;
     }
     
-    requests.push_back(request);
-    sortRequestsByEfficiency();
-}
-
-void Elevator::update() {
-    // Handle door state timing
-    if (doorsOpenState) {
-        // If doors have been open for 1.5 seconds, close them
-        if (doorTimer.getElapsedTime().asSeconds() >= 1.5f) {
-            closeDoors();
-        }
+    // Already have a request for this floor
+    if (!stops().insert(request.getFloor())) {
+        return;
     }
     
-    // Handle door animation
-    if (doorProgress < 1.0f) {
-        float doorTime = doorClock.getElapsedTime().asSeconds();
-        doorProgress = std::min(doorTime / 1.0f, 1.0f); // 1 second for door operation
+    // An idle car starts moving straight away
+    if (!isMoving() && getDoorState() == CLOSED) {
+        processRequests();
+    }
+}
+
+bool Elevator::handleEvent(const SimEvent& event) {
+    // Ignore events that were superseded by a later schedule
+    if (event.generation != eventGeneration) {
+        return false;
     }
     
-    // If we're moving, update position
-    if (moving) {
-        float moveTime = movementClock.getElapsedTime().asSeconds();
-        movementProgress = std::min(moveTime / 2.0f, 1.0f); // 2 seconds per floor
-        
-        if (movementProgress >= 1.0f) {
+    accrueService();
+    switch (event.type) {
+        case SimEvent::CAR_ARRIVAL: {
             // Reached the target floor
-            currentFloor = targetFloor;
-            moving = false;
-            openDoors(); // Open doors when arriving at floor
+            chargeRun(fleet->currentFloor[id], fleet->targetFloor[id]);
+            floorsTravelled += std::abs(fleet->targetFloor[id] - fleet->currentFloor[id]);
+            stopsServed++;
+            fleet->currentFloor[id] = fleet->targetFloor[id];
+            fleet->moving[id] = false;
+            TRACE_EVENT(clock->now(), EventTrace::CAR_ARRIVED, id, fleet->currentFloor[id]);
             
-            // Remove requests for this floor
-            auto it = std::remove_if(requests.begin(), requests.end(),
-                [this](const Request& req) { return req.getFloor() == currentFloor; });
-            requests.erase(it, requests.end());
+            // Clear the stop for this floor
+            stops().erase(fleet->currentFloor[id]);
             
-            // Start door timer
-            doorTimer.restart();
+            openDoors(); // Open doors when arriving at floor
+            break;
         }
+        case SimEvent::DOORS_OPENED:
+            fleet->doorState[id] = OPEN;
+            TRACE_EVENT(clock->now(), EventTrace::DOORS_OPENED, id, fleet->currentFloor[id]);
+            energy.doors += energyModel.doorOperation(SimClock::toSeconds(params.doorOperationTime));
+            // Close once the doors have been open for the dwell time
+            scheduleEvent(fleet->doorOpenedAt[id] + params.doorDwellTime, SimEvent::DOORS_CLOSE_TIMEOUT);
+            break;
+        case SimEvent::DOORS_CLOSE_TIMEOUT:
+            closeDoors();
+            break;
+        case SimEvent::DOORS_CLOSED:
+            fleet->doorState[id] = CLOSED;
+            TRACE_EVENT(clock->now(), EventTrace::DOORS_CLOSED, id, fleet->currentFloor[id]);
+            energy.doors += energyModel.doorOperation(SimClock::toSeconds(params.doorOperationTime));
+            processRequests();
+            break;
+        default:
+            return false;
     }
-    else if (!requests.empty()) {
-        // If we're not moving and doors are closed, process next request
-        processRequests();
+    return true;
+}
+
+bool Elevator::boardPassenger(int passengerId, int destination) {
+    if (isFull()) {
+        return false;
     }
+    
+    riders.push_back({passengerId, destination});
+    fleet->load[id]++;
+    addRequest(Request(destination, Request::NONE)); // Passenger presses the car button
+    return true;
+}
+
+void Elevator::alightPassengers(std::vector<int>& alighted) {
+    // Everyone whose destination is this floor leaves the car
+    auto it = std::remove_if(riders.begin(), riders.end(),
+        [this, &alighted](const Rider& rider) {
+            if (rider.destination == fleet->currentFloor[id]) {
+                alighted.push_back(rider.passengerId);
+                return true;
+            }
+            return false;
+        });
+    riders.erase(it, riders.end());
+    fleet->load[id] = riders.size();
+}
+
+int Elevator::getLoad() const {
+    return fleet->load[id];
+}
+
+int Elevator::getCapacity() const {
+    return fleet->capacity[id];
+}
+
+bool Elevator::isFull() const {
+    return fleet->load[id] >= fleet->capacity[id];
 }
 
 int Elevator::getCurrentFloor() const {
-    if (!moving) {
-        return currentFloor;
+    if (!isMoving()) {
+        return fleet->currentFloor[id];
+    }
+    return static_cast<int>(std::lround(getPosition()));
+}
+
+double Elevator::getPosition() const {
+    int from = fleet->currentFloor[id];
+    if (!isMoving()) {
+        return from;
     }
     
-    // Calculate intermediate floor position for animation
-    float floorDifference = targetFloor - currentFloor;
-    return currentFloor + floorDifference * movementProgress;
+    // Follow the run's motion profile, measured along the shaft
+    int floors = std::abs(fleet->targetFloor[id] - from);
+    double elapsed = SimClock::toSeconds(clock->now() - fleet->movementStart[id]);
+    double covered = runMotion.distanceAt(floors * params.floorHeight, elapsed) / params.floorHeight;
+    return (fleet->targetFloor[id] > from) ? from + covered : from - covered;
 }
 
 bool Elevator::isMoving() const {
-    return moving;
+    return fleet->moving[id] != 0;
 }
 
 bool Elevator::doorsOpen() const {
-    return doorsOpenState;
+    return getDoorState() == OPENING || getDoorState() == OPEN;
+}
+
+Elevator::DoorState Elevator::getDoorState() const {
+    return static_cast<DoorState>(fleet->doorState[id]);
 }
 
 Request::Direction Elevator::getCurrentDirection() const {
-    return direction;
+    return static_cast<Request::Direction>(fleet->direction[id]);
+}
+
+Request::Direction Elevator::getDepartureDirection() const {
+    // Fixed when the doors open; until then, or for a car that answered no
+    // call, the way its next run goes
+    if (getCurrentDirection() != Request::NONE) {
+        return getCurrentDirection();
+    }
+    int nextStop = selectNextStop();
+    if (nextStop == 0 || nextStop == fleet->currentFloor[id]) {
+        return Request::NONE;
+    }
+    return (nextStop > fleet->currentFloor[id]) ? Request::UP : Request::DOWN;
+}
+
+int Elevator::getId() const {
+    return id;
+}
+
+bool Elevator::isIdle() const {
+    return !isMoving() && getDoorState() == CLOSED && stops().empty();
+}
+
+int Elevator::getTargetFloor() const {
+    return isMoving() ? fleet->targetFloor[id] : fleet->currentFloor[id];
+}
+
+int Elevator::getStopCount() const {
+    return stops().size();
+}
+
+int Elevator::getHighestStop() const {
+    return stops().highest();
+}
+
+int Elevator::getLowestStop() const {
+    return stops().lowest();
+}
+
+int Elevator::getNextStopAtOrAbove(int floor) const {
+    return stops().nextAtOrAbove(floor);
+}
+
+int Elevator::getNextStopAtOrBelow(int floor) const {
+    return stops().nextAtOrBelow(floor);
+}
+
+int Elevator::countStopsBetween(int lowFloor, int highFloor) const {
+    return stops().countBetween(lowFloor, highFloor);
+}
+
+SimTime Elevator::getTravelTime(int floors) const {
+    return floors > 0 ? SimClock::fromSeconds(motion.travelTime(floors * params.floorHeight)) : 0;
+}
+
+SimTime Elevator::getTravelTime(int floors, int stops) const {
+    if (floors <= 0) {
+        return 0;
+    }
+    
+    // Each intermediate stop splits the trip into another run from rest
+    int runs = std::max(stops, 0) + 1;
+    double runLength = floors * params.floorHeight / runs;
+    return SimClock::fromSeconds(runs * motion.travelTime(runLength));
+}
+
+SimTime Elevator::getDoorCycleTime() const {
+    // Doors start closing once the dwell (counted from opening) has elapsed
+    return params.doorDwellTime + params.doorOperationTime;
+}
+
+SimTime Elevator::getBusyTime() const {
+    SimTime now = clock->now();
+    if (isMoving()) {
+        return std::max<SimTime>(0, fleet->arrivalTime[id] - now);
+    }
+    
+    switch (getDoorState()) {
+        case OPENING:
+        case OPEN:
+            return std::max<SimTime>(0, fleet->doorOpenedAt[id] + params.doorDwellTime - now) + params.doorOperationTime;
+        case CLOSING:
+            return params.doorOperationTime;
+        default:
+            return 0;
+    }
+}
+
+void Elevator::setParams(const Params& newParams) {
+    // Validate before touching anything
+    if (!(newParams.floorHeight > 0.0)) {
+        throw std::invalid_argument("Floor height must be positive");
+    }
+    MotionProfile newMotion(newParams.ratedSpeed, newParams.acceleration, newParams.jerk);
+    EnergyModel newEnergyModel(newParams.energy);
+    
+    // Standby drawn so far is charged at the old rate
+    accrueStandby();
+    motion = newMotion;
+    energyModel = newEnergyModel;
+    params = newParams;
+    fitTiming();
+}
+
+const Elevator::Params& Elevator::getParams() const {
+    return params;
+}
+
+void Elevator::setCapacity(int capacity) {
+    // Riders already aboard stay; the car just stops boarding until it
+    // is back under the new limit
+    fleet->capacity[id] = capacity;
+    riders.reserve(capacity);
+}
+
+int Elevator::getFloorsTravelled() const {
+    return floorsTravelled;
+}
+
+int Elevator::getStopsServed() const {
+    return stopsServed;
+}
+
+SimTime Elevator::getServiceTime() const {
+    return serviceTime + (inService() ? clock->now() - serviceSince : 0);
+}
+
+void Elevator::resetStatistics() {
+    floorsTravelled = 0;
+    stopsServed = 0;
+    energy = EnergyUse{0.0, 0.0, 0.0, 0.0};
+    standbySince = clock->now();
+    serviceTime = 0;
+    serviceSince = clock->now();
+}
+
+void Elevator::reset() {
+    fleet->resetCar(id);
+    fleet->movementStart[id] = clock->now();
+    fleet->doorOpenedAt[id] = clock->now();
+    runMotion = motion;
+    eventGeneration = 0;
+    riders.clear();
+    resetStatistics();
+}
+
+void Elevator::save(BinaryWriter& out) const {
+    out.writeDouble(params.ratedSpeed);
+    out.writeDouble(params.acceleration);
+    out.writeDouble(params.jerk);
+    out.writeDouble(params.floorHeight);
+    out.writeInt64(params.doorOperationTime);
+    out.writeInt64(params.doorDwellTime);
+    out.writeDouble(params.energy.carMass);
+    out.writeDouble(params.energy.passengerMass);
+    out.writeDouble(params.energy.counterweightBalance);
+    out.writeDouble(params.energy.driveEfficiency);
+    out.writeDouble(params.energy.regenEfficiency);
+    out.writeDouble(params.energy.standbyPower);
+    out.writeDouble(params.energy.doorPower);
+    runMotion.save(out);
+    
+    out.writeDouble(energy.motor);
+    out.writeDouble(energy.regenerated);
+    out.writeDouble(energy.doors);
+    out.writeDouble(energy.standby);
+    out.writeInt64(standbySince);
+    
+    out.writeUInt32(eventGeneration);
+    out.writeInt(floorsTravelled);
+    out.writeInt(stopsServed);
+    out.writeInt64(serviceTime);
+    out.writeInt64(serviceSince);
+    out.writeUInt64(riders.size());
+    for (const Rider& rider : riders) {
+        out.writeInt(rider.passengerId);
+        out.writeInt(rider.destination);
+    }
+}
+
+void Elevator::restore(BinaryReader& in) {
+    Params saved;
+    saved.ratedSpeed = in.readDouble();
+    saved.acceleration = in.readDouble();
+    saved.jerk = in.readDouble();
+    saved.floorHeight = in.readDouble();
+    saved.doorOperationTime = in.readInt64();
+    saved.doorDwellTime = in.readInt64();
+    saved.energy.carMass = in.readDouble();
+    saved.energy.passengerMass = in.readDouble();
+    saved.energy.counterweightBalance = in.readDouble();
+    saved.energy.driveEfficiency = in.readDouble();
+    saved.energy.regenEfficiency = in.readDouble();
+    saved.energy.standbyPower = in.readDouble();
+    saved.energy.doorPower = in.readDouble();
+    SimTime hour = SimClock::fromSeconds(3600.0);
+    if (!(saved.ratedSpeed > 0.0) || !(saved.acceleration > 0.0) || !(saved.jerk > 0.0) ||
+        !(saved.floorHeight > 0.0) || saved.doorOperationTime < 0 || saved.doorOperationTime > hour ||
+        saved.doorDwellTime < 0 || saved.doorDwellTime > hour) {
+        throw std::runtime_error("Snapshot is corrupt: car settings out of range");
+    }
+    setParams(saved);
+    runMotion = MotionProfile::restore(in);
+    
+    energy.motor = in.readDouble();
+    energy.regenerated = in.readDouble();
+    energy.doors = in.readDouble();
+    energy.standby = in.readDouble();
+    standbySince = in.readInt64();
+    
+    eventGeneration = in.readUInt32();
+    floorsTravelled = in.readInt();
+    stopsServed = in.readInt();
+    serviceTime = in.readInt64();
+    serviceSince = in.readInt64();
+    riders.resize(in.readCount(1u << 20));
+    for (Rider& rider : riders) {
+        rider.passengerId = in.readInt();
+        rider.destination = in.readInt();
+        if (rider.destination < 1 || rider.destination > fleet->numFloors) {
+            throw std::runtime_error("Snapshot is corrupt: rider bound outside the building");
+        }
+    }
+    if (riders.size() != static_cast<size_t>(fleet->load[id])) {
+        throw std::runtime_error("Snapshot is corrupt: car load does not match its riders");
+    }
+}
+
+void Elevator::checkRiders(size_t numPassengers) const {
+    for (const Rider& rider : riders) {
+        if (rider.passengerId < 0 || static_cast<size_t>(rider.passengerId) >= numPassengers) {
+            throw std::runtime_error("Snapshot is corrupt: unknown rider");
+        }
+    }
+}
+
+Elevator::EnergyUse Elevator::getEnergyUse() const {
+    EnergyUse use = energy;
+    use.standby += energyModel.standby(SimClock::toSeconds(clock->now() - standbySince));
+    return use;
+}
+
+double Elevator::getNetEnergy() const {
+    EnergyUse use = getEnergyUse();
+    return use.motor + use.doors + use.standby - use.regenerated;
+}
+
+double Elevator::estimateRunEnergy(int fromFloor, int toFloor) const {
+    double height = (toFloor - fromFloor) * params.floorHeight;
+    EnergyModel::RunEnergy run = energyModel.run(height, motion.peakSpeed(std::abs(height)),
+                                                 fleet->load[id], fleet->capacity[id]);
+    return run.drawn - run.regenerated;
+}
+
+void Elevator::chargeRun(int fromFloor, int toFloor) {
+    double height = (toFloor - fromFloor) * params.floorHeight;
+    EnergyModel::RunEnergy run = energyModel.run(height, runMotion.peakSpeed(std::abs(height)),
+                                                 fleet->load[id], fleet->capacity[id]);
+    energy.motor += run.drawn;
+    energy.regenerated += run.regenerated;
+}
+
+void Elevator::accrueStandby() {
+    SimTime now = clock->now();
+    energy.standby += energyModel.standby(SimClock::toSeconds(now - standbySince));
+    standbySince = now;
+}
+
+bool Elevator::inService() const {
+    return isMoving() || getDoorState() != CLOSED;
+}
+
+void Elevator::accrueService() {
+    SimTime now = clock->now();
+    if (inService()) {
+        serviceTime += now - serviceSince;
+    }
+    serviceSince = now;
+}
+
+void Elevator::fitTiming() {
+    DispatchKernel::Timing timing = DispatchKernel::fit(*this, fleet->numFloors);
+    fleet->secondsPerFloor[id] = timing.secondsPerFloor;
+    fleet->secondsPerStop[id] = timing.secondsPerStop;
+    fleet->loadPenalty[id] = timing.loadPenalty;
+}
+
+void Elevator::scheduleEvent(SimTime time, SimEvent::Type type) {
+    // A car has at most one pending state change, so scheduling a new one
+    // invalidates whatever was queued before
+    eventGeneration++;
+    events->push(time, type, id, eventGeneration);
 }
 
 void Elevator::processRequests() {
-    if (requests.empty()) {
-        direction = Request::NONE;
+    if (stops().empty()) {
+        fleet->direction[id] = Request::NONE;
+        return;
+    }
+    
+    int nextStop = selectNextStop();
+    
+    // A request for the floor we are already on is served by opening the doors
+    if (nextStop == fleet->currentFloor[id]) {
+        stops().erase(fleet->currentFloor[id]);
+        openDoors();
         return;
     }
     
-    // Process the first request in the queue
-    const Request& nextRequest = requests.front();
-    moveToFloor(nextRequest.getFloor());
+    moveToFloor(nextStop);
+}
+
+StopSet Elevator::stops() const {
+    return StopSet(fleet->stopWords(id), &fleet->stopCount[id], fleet->numFloors);
 }
 
-void Elevator::sortRequestsByEfficiency() {
-    if (requests.size() <= 1) {
+void Elevator::answerHallCalls() {
+    int floor = fleet->currentFloor[id];
+    if (floor < 1 || floor > static_cast<int>(floors->size())) {
         return;
     }
     
-    // Sort requests based on the current direction
-    // If going up, handle all up requests first in ascending order
-    // If going down, handle all down requests first in descending order
-    std::sort(requests.begin(), requests.end(), 
-        [this](const Request& a, const Request& b) {
-            if (direction == Request::UP) {
-                // If both floors are above current, sort by ascending floor
-                if (a.getFloor() >= currentFloor && b.getFloor() >= currentFloor) {
-                    return a.getFloor() < b.getFloor();
-                }
-                // If both floors are below current, sort by descending floor
-                if (a.getFloor() < currentFloor && b.getFloor() < currentFloor) {
-                    return a.getFloor() > b.getFloor();
-                }
-                // Prioritize floors above current
-                return a.getFloor() >= currentFloor && b.getFloor() < currentFloor;
-            }
-            else if (direction == Request::DOWN) {
-                // If both floors are below current, sort by descending floor
-                if (a.getFloor() <= currentFloor && b.getFloor() <= currentFloor) {
-                    return a.getFloor() > b.getFloor();
-                }
-                // If both floors are above current, sort by ascending floor
-                if (a.getFloor() > currentFloor && b.getFloor() > currentFloor) {
-                    return a.getFloor() < b.getFloor();
-                }
-                // Prioritize floors below current
-                return a.getFloor() <= currentFloor && b.getFloor() > currentFloor;
-            }
-            else {
-                // If idle, sort by proximity to current floor
-                return std::abs(a.getFloor() - currentFloor) < std::abs(b.getFloor() - currentFloor);
-            }
-        });
-}
\ No newline at end of file
+    // The car answers the call for the way it will leave, which is the way
+    // its next run goes. A car that is emptying here is free to turn round
+    // for a call waiting in the other direction instead, and one with
+    // nowhere to go takes the call in the direction it arrived, or
+    // whichever call is lit. With no call to answer it stays uncommitted
+    // and leaves the way its first passenger is going.
+    Floor& landing = (*floors)[floor - 1];
+    Request::Direction direction = Request::NONE;
+    int nextStop = selectNextStop();
+    if (nextStop != 0) {
+        direction = (nextStop > floor) ? Request::UP : Request::DOWN;
+    }
+    
+    bool emptying = std::none_of(riders.begin(), riders.end(),
+                                 [floor](const Rider& rider) { return rider.destination != floor; });
+    if (emptying && (direction == Request::NONE || !landing.hasCall(direction))) {
+        Request::Direction arrival = getCurrentDirection();
+        if (arrival != Request::NONE && landing.hasCall(arrival)) {
+            direction = arrival;
+        } else if (landing.hasCall(Request::UP)) {
+            direction = Request::UP;
+        } else if (landing.hasCall(Request::DOWN)) {
+            direction = Request::DOWN;
+        }
+    }
+    
+    fleet->direction[id] = direction;
+    if (direction != Request::NONE) {
+        landing.clearCall(direction);
+    }
+}
+
+int Elevator::selectNextStop() const {
+    // Keep going in the current direction while there are stops ahead,
+    // then turn around for the stops behind
+    int above = stops().nextAtOrAbove(fleet->currentFloor[id]);
+    int below = stops().nextAtOrBelow(fleet->currentFloor[id]);
+    
+    if (getCurrentDirection() == Request::UP) {
+        return above ? above : below;
+    }
+    if (getCurrentDirection() == Request::DOWN) {
+        return below ? below : above;
+    }
+    
+    // If idle, go to the closest stop
+    if (!above) {
+        return below;
+    }
+    if (!below) {
+        return above;
+    }
+    return (above - fleet->currentFloor[id] <= fleet->currentFloor[id] - below) ? above : below;
+}
@@ -1,42 +1,155 @@
 #ifndef ELEVATOR_H
 #define ELEVATOR_H
 
-#include <SFML/Graphics.hpp>
 #include <vector>
+#include "EnergyModel.h"
+#include "EventQueue.h"
+#include "FleetState.h"
+#include "Floor.h"
+#include "MotionProfile.h"
 #include "Request.h"
+#include "SimClock.h"
+#include "StopSet.h"
 
+// One car of the fleet. Position, doors, direction, load and queued stops
+// live in the building's FleetState; an Elevator runs the car's state
+// machine over its slot there and its accessors are views of that slot.
 class Elevator {
 public:
-    Elevator(int id, int totalFloors);
+    enum DoorState { CLOSED, OPENING, OPEN, CLOSING };
+    
+    // Per-car drive and door settings. A change takes effect from the
+    // car's next scheduled run or door operation.
+    struct Params {
+        double ratedSpeed;         // m/s
+        double acceleration;       // m/s^2
+        double jerk;               // m/s^3
+        double floorHeight;        // m between floors
+        SimTime doorOperationTime; // Doors open or close
+        SimTime doorDwellTime;     // Doors stay open
+        EnergyModel::Params energy;
+    };
+    static Params defaultParams();
+    
+    // Adds a new car to the fleet; its id is the car's index in the fleet.
+    // Opening the doors at a floor answers the hall call for the direction
+    // the car leaves in.
+    Elevator(FleetState& fleet, std::vector<Floor>& floors, int capacity, const SimClock& clock, EventQueue& events);
     
     void moveToFloor(int floor);
     void openDoors();
     void closeDoors();
     void addRequest(const Request& request);
-    void update();
     
-    int getCurrentFloor() const;
+    // Apply a scheduled event addressed to this elevator; returns false if
+    // the event was stale
+    bool handleEvent(const SimEvent& event);
+    
+    // Passenger load; boarding fails once the car is at capacity
+    bool boardPassenger(int passengerId, int destination);
+    void alightPassengers(std::vector<int>& alighted);
+    int getLoad() const;
+    int getCapacity() const;
+    bool isFull() const;
+    
+    int getCurrentFloor() const;  // Nearest floor while moving
+    double getPosition() const;   // In floors, fractional while moving
     bool isMoving() const;
     bool doorsOpen() const;
+    DoorState getDoorState() const;
     Request::Direction getCurrentDirection() const;
+    Request::Direction getDepartureDirection() const; // Way it leaves this floor; NONE if not yet known
+    int getId() const;
+    bool isIdle() const;
+    
+    // Queries used by dispatch strategies
+    int getTargetFloor() const;
+    int getStopCount() const;
+    int getHighestStop() const;  // 0 if no stops are queued
+    int getLowestStop() const;   // 0 if no stops are queued
+    int getNextStopAtOrAbove(int floor) const; // 0 if none
+    int getNextStopAtOrBelow(int floor) const; // 0 if none
+    int countStopsBetween(int lowFloor, int highFloor) const; // Inclusive range
+    SimTime getTravelTime(int floors) const; // One run from rest to rest
+    SimTime getTravelTime(int floors, int stops) const; // Split into stops + 1 equal runs
+    SimTime getDoorCycleTime() const;
+    SimTime getBusyTime() const; // Time until the car can start its next run
+    
+    void setParams(const Params& params);
+    const Params& getParams() const;
+    void setCapacity(int capacity);
+    
+    // Run statistics
+    int getFloorsTravelled() const;
+    int getStopsServed() const;
+    SimTime getServiceTime() const; // Moving or with its doors not closed
+    
+    // Energy used so far, in joules
+    struct EnergyUse {
+        double motor;       // Drawn by the drive
+        double regenerated; // Fed back by the drive
+        double doors;
+        double standby;
+    };
+    EnergyUse getEnergyUse() const;
+    double getNetEnergy() const; // Everything drawn less what was fed back
+    
+    // Net joules for a run between two floors with the current load
+    double estimateRunEnergy(int fromFloor, int toFloor) const;
+    
+    // Zero the run statistics and energy account, e.g. after a warm-up
+    void resetStatistics();
+    
+    // Park the car empty at floor 1 with no stops, as when it was added,
+    // for a new run of the building; settings and capacity are kept
+    void reset();
+    
+    // Checkpointing of the car's own state; its slot in the fleet is saved
+    // with the fleet
+    void save(BinaryWriter& out) const;
+    void restore(BinaryReader& in);
+    
+    // Throws unless every rider is one of the first numPassengers
+    // passengers; for after the building has restored them
+    void checkRiders(size_t numPassengers) const;
 
 private:
+    FleetState* fleet;      // Hot state, owned by the building
+    std::vector<Floor>* floors; // Landings, owned by the building
     int id;
-    int currentFloor;
-    bool moving;
-    bool doorsOpenState;
-    std::vector<Request> requests;
-    int totalFloors;
-    Request::Direction direction;
-    float movementProgress; // 0.0 to 1.0 for smooth animation
-    float doorProgress;     // 0.0 to 1.0 for door animation
-    sf::Clock movementClock;
-    sf::Clock doorClock;
-    sf::Clock doorTimer;    // Timer for how long doors stay open
-    int targetFloor;
+    const SimClock* clock;  // Simulation clock owned by the building
+    EventQueue* events;     // Event queue owned by the building
+    Params params;
+    MotionProfile motion;     // From params, for new runs and estimates
+    MotionProfile runMotion;  // Profile of the run in progress
+    EnergyModel energyModel;
+    EnergyUse energy;
+    SimTime standbySince;     // Standby energy up to here is already in energy
+    std::uint32_t eventGeneration; // Only the most recently scheduled event is live
+    int floorsTravelled;
+    int stopsServed;
+    SimTime serviceTime;      // In service up to serviceSince
+    SimTime serviceSince;
+    
+    // Passengers currently in the car; room for a full load is reserved
+    struct Rider {
+        int passengerId;
+        int destination;
+    };
+    std::vector<Rider> riders;
+    
+    // Floors this car has been asked to stop at
+    StopSet stops() const;
 
+    void scheduleEvent(SimTime time, SimEvent::Type type);
+    void chargeRun(int fromFloor, int toFloor); // Load does not change during a run
+    void accrueStandby();
+    bool inService() const;
+    void accrueService(); // Before anything that can start or end a spell in service
+    void fitTiming();     // Into the fleet arrays, after a change of settings
     void processRequests();
-    void sortRequestsByEfficiency();
+    void answerHallCalls();
+    int selectNextStop() const;
 };
 
 #endif // ELEVATOR_H
\ No newline at end of file
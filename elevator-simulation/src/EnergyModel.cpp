@@ -0,0 +1,75 @@
+#include "EnergyModel.h"
+#include <stdexcept>
+
+namespace {
+const double GRAVITY = 9.81; // m/s^2
+}
+
+EnergyModel::Params EnergyModel::defaultParams() {
+    Params params;
+    params.carMass = 1000.0;
+    params.passengerMass = 75.0;
+    params.counterweightBalance = 0.45;
+    params.driveEfficiency = 0.8;
+    params.regenEfficiency = 0.6;
+    params.standbyPower = 200.0;
+    params.doorPower = 100.0;
+    return params;
+}
+
+EnergyModel::EnergyModel(const Params& params) : params(params) {
+    if (!(params.carMass > 0.0) || !(params.passengerMass > 0.0)) {
+        throw std::invalid_argument("Car and passenger mass must be positive");
+    }
+    if (!(params.counterweightBalance >= 0.0 && params.counterweightBalance <= 1.0)) {
+        throw std::invalid_argument("Counterweight balance must be between 0 and 1");
+    }
+    if (!(params.driveEfficiency > 0.0 && params.driveEfficiency <= 1.0) ||
+        !(params.regenEfficiency >= 0.0 && params.regenEfficiency <= 1.0)) {
+        throw std::invalid_argument("Efficiencies must be between 0 and 1");
+    }
+    if (!(params.standbyPower >= 0.0) || !(params.doorPower >= 0.0)) {
+        throw std::invalid_argument("Power draw cannot be negative");
+    }
+}
+
+EnergyModel::RunEnergy EnergyModel::run(double height, double peakSpeed, int load, int capacity) const {
+    RunEnergy energy = {0.0, 0.0};
+    if (height == 0.0) {
+        return energy;
+    }
+    
+    // Potential energy the drive has to supply (positive) or can recover
+    // (negative)
+    double imbalance = params.passengerMass * (load - params.counterweightBalance * capacity);
+    double potential = imbalance * GRAVITY * height;
+    if (potential > 0.0) {
+        energy.drawn += potential / params.driveEfficiency;
+    } else {
+        energy.regenerated += -potential * params.driveEfficiency * params.regenEfficiency;
+    }
+    
+    // Car, counterweight and passengers all get up to speed and stop again
+    double movingMass = 2.0 * params.carMass
+                      + params.passengerMass * (load + params.counterweightBalance * capacity);
+    double kinetic = 0.5 * movingMass * peakSpeed * peakSpeed;
+    energy.drawn += kinetic / params.driveEfficiency;
+    energy.regenerated += kinetic * params.driveEfficiency * params.regenEfficiency;
+    return energy;
+}
+
+double EnergyModel::doorOperation(double seconds) const {
+    return params.doorPower * seconds;
+}
+
+double EnergyModel::standby(double seconds) const {
+    return params.standbyPower * seconds;
+}
+
+const EnergyModel::Params& EnergyModel::getParams() const {
+    return params;
+}
+
+double EnergyModel::toKWh(double joules) {
+    return joules / 3.6e6;
+}
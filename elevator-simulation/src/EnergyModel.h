@@ -0,0 +1,50 @@
+#ifndef ENERGYMODEL_H
+#define ENERGYMODEL_H
+
+// Energy drawn and recovered by one car. The counterweight balances the
+// empty car plus a fraction of the rated load, so the drive only lifts or
+// lowers the difference:
+//
+//   imbalance = load * passengerMass - balance * capacity * passengerMass
+//
+// A run that raises the imbalance (heavy car up, light car down) draws
+// that potential energy through the drive; a run that lowers it (light
+// car up, heavy car down) overhauls the motor, and a regenerative drive
+// feeds part of that energy back. Accelerating the moving masses costs
+// their kinetic energy, part of which is recovered again while braking.
+// Doors draw power while they move, and the controller draws standby
+// power at all times.
+class EnergyModel {
+public:
+    struct Params {
+        double carMass;              // kg, empty car
+        double passengerMass;        // kg per passenger
+        double counterweightBalance; // Share of the rated load the counterweight offsets
+        double driveEfficiency;      // Motor, inverter and gearing
+        double regenEfficiency;      // Share of recoverable energy fed back; 0 burns it in a resistor
+        double standbyPower;         // W
+        double doorPower;            // W while the doors move
+    };
+    static Params defaultParams();
+    
+    explicit EnergyModel(const Params& params);
+    
+    // Energy for one run in joules; height is positive up and negative down
+    struct RunEnergy {
+        double drawn;
+        double regenerated;
+    };
+    RunEnergy run(double height, double peakSpeed, int load, int capacity) const;
+    
+    double doorOperation(double seconds) const;
+    double standby(double seconds) const;
+    
+    const Params& getParams() const;
+    
+    static double toKWh(double joules);
+    
+private:
+    Params params;
+};
+
+#endif // ENERGYMODEL_H
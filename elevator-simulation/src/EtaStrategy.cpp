@@ -0,0 +1,24 @@
+#include "EtaStrategy.h"
+
+const char* EtaStrategy::getName() const {
+    return "eta";
+}
+
+double EtaStrategy::cost(const Request& request, const Elevator& elevator,
+                         int /*numFloors*/, int /*numElevators*/) const {
+    Sweep sweep = estimateSweep(request, elevator);
+    
+    // Each stop on the way splits the trip into another run from rest and
+    // adds a door cycle
+    SimTime eta = elevator.getBusyTime()
+                + elevator.getTravelTime(sweep.floors, sweep.stops)
+                + sweep.stops * elevator.getDoorCycleTime();
+    
+    double loadFactor = static_cast<double>(elevator.getLoad()) / elevator.getCapacity();
+    return SimClock::toSeconds(eta) + loadFactor * SimClock::toSeconds(elevator.getDoorCycleTime());
+}
+
+double EtaStrategy::callAgeCost(const Request& request, const Elevator& elevator,
+                                const std::vector<Floor>& floors, SimTime now) const {
+    return delayedCallCost(request, elevator, floors, now);
+}
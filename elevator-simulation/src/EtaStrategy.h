@@ -0,0 +1,21 @@
+#ifndef ETASTRATEGY_H
+#define ETASTRATEGY_H
+
+#include "DispatchStrategy.h"
+
+// Minimises the estimated time until a car reaches the call, counting the
+// run time and a door cycle for every stop on the way. Cars close to their
+// capacity are penalised since they may arrive full, and so are cars whose
+// new stop would hold up calls that have already waited long.
+class EtaStrategy : public DispatchStrategy {
+public:
+    const char* getName() const override;
+    
+protected:
+    double cost(const Request& request, const Elevator& elevator,
+                int numFloors, int numElevators) const override;
+    double callAgeCost(const Request& request, const Elevator& elevator,
+                       const std::vector<Floor>& floors, SimTime now) const override;
+};
+
+#endif // ETASTRATEGY_H
@@ -0,0 +1,92 @@
+#include "EventQueue.h"
+#include <algorithm>
+#include <stdexcept>
+
+EventQueue::EventQueue() : nextSequence(0) {
+}
+
+void EventQueue::push(SimTime time, SimEvent::Type type, int elevatorId, std::uint32_t generation,
+                      int floor, Request::Direction direction, int destination, int journey) {
+    SimEvent event;
+    event.time = time;
+    event.sequence = nextSequence++;
+    event.type = type;
+    event.elevatorId = elevatorId;
+    event.generation = generation;
+    event.floor = floor;
+    event.direction = direction;
+    event.destination = destination;
+    event.journey = journey;
+    events.push_back(event);
+    std::push_heap(events.begin(), events.end(), Later());
+}
+
+SimEvent EventQueue::pop() {
+    std::pop_heap(events.begin(), events.end(), Later());
+    SimEvent event = events.back();
+    events.pop_back();
+    return event;
+}
+
+const SimEvent& EventQueue::top() const {
+    return events.front();
+}
+
+bool EventQueue::empty() const {
+    return events.empty();
+}
+
+size_t EventQueue::size() const {
+    return events.size();
+}
+
+void EventQueue::save(BinaryWriter& out) const {
+    out.writeUInt64(nextSequence);
+    out.writeUInt64(events.size());
+    
+    // Events carry their sequence numbers, so heap order does not matter
+    std::vector<SimEvent> pending = events;
+    while (!pending.empty()) {
+        std::pop_heap(pending.begin(), pending.end(), Later());
+        const SimEvent& event = pending.back();
+        out.writeInt64(event.time);
+        out.writeUInt64(event.sequence);
+        out.writeUInt8(event.type);
+        out.writeInt(event.elevatorId);
+        out.writeUInt32(event.generation);
+        out.writeInt(event.floor);
+        out.writeUInt8(event.direction);
+        out.writeInt(event.destination);
+        out.writeInt(event.journey);
+        pending.pop_back();
+    }
+}
+
+void EventQueue::restore(BinaryReader& in) {
+    clear();
+    nextSequence = in.readUInt64();
+    size_t count = in.readCount(1u << 30);
+    for (size_t i = 0; i < count; i++) {
+        SimEvent event;
+        event.time = in.readInt64();
+        event.sequence = in.readUInt64();
+        std::uint8_t type = in.readUInt8();
+        if (type > SimEvent::DISPATCH_BATCH) {
+            throw std::runtime_error("Snapshot is corrupt: unknown event type");
+        }
+        event.type = static_cast<SimEvent::Type>(type);
+        event.elevatorId = in.readInt();
+        event.generation = in.readUInt32();
+        event.floor = in.readInt();
+        event.direction = static_cast<Request::Direction>(in.readUInt8());
+        event.destination = in.readInt();
+        event.journey = in.readInt();
+        events.push_back(event);
+        std::push_heap(events.begin(), events.end(), Later());
+    }
+}
+
+void EventQueue::clear() {
+    events.clear();
+    nextSequence = 0;
+}
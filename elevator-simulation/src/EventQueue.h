@@ -0,0 +1,66 @@
+#ifndef EVENTQUEUE_H
+#define EVENTQUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BinaryStream.h"
+#include "Request.h"
+#include "SimClock.h"
+
+// A scheduled state change in the simulation
+struct SimEvent {
+    enum Type {
+        CAR_ARRIVAL,          // Car reached its target floor
+        DOORS_OPENED,         // Doors finished opening
+        DOORS_CLOSE_TIMEOUT,  // Dwell time elapsed, doors start closing
+        DOORS_CLOSED,         // Doors finished closing
+        NEW_CALL,             // A scheduled call is registered
+        NEW_PASSENGER,        // A passenger appears at a floor
+        DISPATCH_BATCH        // Destination calls collected so far are assigned
+    };
+    
+    SimTime time;
+    std::uint64_t sequence;   // Breaks ties so equal-time events keep insertion order
+    Type type;
+    int elevatorId;           // -1 for events not tied to a car
+    std::uint32_t generation; // Lets a car invalidate events it no longer wants
+    int floor;
+    Request::Direction direction;
+    int destination;          // Destination floor for NEW_PASSENGER
+    int journey;              // Campus journey of a NEW_PASSENGER, -1 for none
+};
+
+// Priority queue of pending events ordered by time, then insertion order
+class EventQueue {
+public:
+    EventQueue();
+    
+    void push(SimTime time, SimEvent::Type type, int elevatorId, std::uint32_t generation,
+              int floor = 0, Request::Direction direction = Request::NONE, int destination = 0,
+              int journey = -1);
+    SimEvent pop();
+    const SimEvent& top() const;
+    bool empty() const;
+    size_t size() const;
+    void clear(); // Keeps the heap's storage for the next run
+    
+    // Checkpointing; a restored queue pops the same events in the same order
+    void save(BinaryWriter& out) const;
+    void restore(BinaryReader& in);
+    
+private:
+    struct Later {
+        bool operator()(const SimEvent& a, const SimEvent& b) const {
+            if (a.time != b.time) {
+                return a.time > b.time;
+            }
+            return a.sequence > b.sequence;
+        }
+    };
+    
+    std::vector<SimEvent> events; // Binary heap under Later
+    std::uint64_t nextSequence;
+};
+
+#endif // EVENTQUEUE_H
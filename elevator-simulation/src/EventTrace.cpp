@@ -0,0 +1,227 @@
+#include "EventTrace.h"
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+
+std::atomic<bool> EventTrace::enabled(false);
+
+namespace {
+
+std::mutex registryMutex;
+std::size_t ringCapacity = EventTrace::DEFAULT_CAPACITY;
+
+const char* directionName(int direction) {
+    switch (direction) {
+        case Request::UP: return "up";
+        case Request::DOWN: return "down";
+        default: return "none";
+    }
+}
+
+// Per-car state while pairing departures with arrivals and door openings
+// with closings into slices
+struct CarTrack {
+    SimTime departedAt = -1;
+    int departedFrom = 0;
+    SimTime doorsOpenedAt = -1;
+    int doorsFloor = 0;
+};
+
+class ChromeTraceWriter {
+public:
+    explicit ChromeTraceWriter(std::ostream& out) : out(out), first(true) {
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    }
+    
+    void finish() {
+        out << "\n]}\n";
+    }
+    
+    void name(const char* kind, std::size_t pid, int tid, const std::string& value) {
+        begin();
+        out << "{\"name\":\"" << kind << "\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tid
+            << ",\"args\":{\"name\":\"" << value << "\"}}";
+    }
+    
+    void instant(const std::string& name, std::size_t pid, int tid, SimTime time,
+                 int floor, const char* direction) {
+        begin();
+        out << "{\"name\":\"" << name << "\",\"ph\":\"i\",\"s\":\"t\",\"pid\":" << pid << ",\"tid\":" << tid
+            << ",\"ts\":" << time << ",\"args\":{\"floor\":" << floor;
+        if (direction) {
+            out << ",\"direction\":\"" << direction << "\"";
+        }
+        out << "}}";
+    }
+    
+    void slice(const std::string& name, std::size_t pid, int tid, SimTime start, SimTime end, int floor) {
+        begin();
+        out << "{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << tid
+            << ",\"ts\":" << start << ",\"dur\":" << (end - start) << ",\"args\":{\"floor\":" << floor << "}}";
+    }
+    
+private:
+    std::ostream& out;
+    bool first;
+    
+    void begin() {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    }
+};
+
+}
+
+std::vector<std::unique_ptr<EventTrace::Ring>>& EventTrace::registry() {
+    // Rings outlive their threads so a run can be exported after its
+    // workers exit
+    static std::vector<std::unique_ptr<Ring>> rings;
+    return rings;
+}
+
+bool EventTrace::isCompiledIn() {
+#ifdef ELEVATOR_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void EventTrace::setEnabled(bool on) {
+    enabled.store(on, std::memory_order_relaxed);
+}
+
+bool EventTrace::isEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void EventTrace::setCapacity(std::size_t records) {
+    std::size_t capacity = 1;
+    while (capacity < records) {
+        capacity <<= 1;
+    }
+    std::lock_guard<std::mutex> lock(registryMutex);
+    ringCapacity = capacity;
+}
+
+EventTrace::Ring* EventTrace::attachThread() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::unique_ptr<Ring> ring(new Ring());
+    ring->records.reset(new Record[ringCapacity]);
+    ring->mask = ringCapacity - 1;
+    ring->head.store(0, std::memory_order_relaxed);
+    localRing = ring.get();
+    registry().push_back(std::move(ring));
+    return localRing;
+}
+
+std::uint64_t EventTrace::getRecordCount() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::uint64_t count = 0;
+    for (const auto& ring : registry()) {
+        count += std::min(ring->head.load(std::memory_order_acquire), ring->mask + 1);
+    }
+    return count;
+}
+
+std::uint64_t EventTrace::getDroppedCount() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::uint64_t dropped = 0;
+    for (const auto& ring : registry()) {
+        std::uint64_t head = ring->head.load(std::memory_order_acquire);
+        dropped += head - std::min(head, ring->mask + 1);
+    }
+    return dropped;
+}
+
+void EventTrace::clear() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& ring : registry()) {
+        ring->head.store(0, std::memory_order_release);
+    }
+}
+
+void EventTrace::exportChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Could not create timeline file: " + path);
+    }
+    
+    std::lock_guard<std::mutex> lock(registryMutex);
+    ChromeTraceWriter writer(out);
+    const std::vector<std::unique_ptr<Ring>>& rings = registry();
+    for (std::size_t pid = 0; pid < rings.size(); pid++) {
+        const Ring& ring = *rings[pid];
+        std::uint64_t head = ring.head.load(std::memory_order_acquire);
+        std::uint64_t count = std::min(head, ring.mask + 1);
+        if (count == 0) {
+            continue;
+        }
+        
+        writer.name("process_name", pid, 0, "Simulation thread " + std::to_string(pid + 1));
+        writer.name("thread_name", pid, 0, "Hall calls");
+        
+        // Car tracks are named as they first appear; tid 0 is the hall calls
+        std::vector<CarTrack> cars;
+        for (std::uint64_t i = head - count; i < head; i++) {
+            const Record& entry = ring.records[i & ring.mask];
+            int tid = entry.car + 1;
+            if (entry.car >= 0 && entry.car >= static_cast<int>(cars.size())) {
+                for (int car = cars.size(); car <= entry.car; car++) {
+                    writer.name("thread_name", pid, car + 1, "Car " + std::to_string(car + 1));
+                }
+                cars.resize(entry.car + 1);
+            }
+            
+            switch (entry.type) {
+                case CALL_REGISTERED:
+                    if (entry.car < 0) {
+                        writer.instant("Hall call", pid, 0, entry.time, entry.floor, directionName(entry.direction));
+                    } else {
+                        writer.instant("Car call", pid, tid, entry.time, entry.floor, nullptr);
+                    }
+                    break;
+                case CALL_ASSIGNED:
+                    writer.instant("Assigned", pid, tid, entry.time, entry.floor, directionName(entry.direction));
+                    break;
+                case CAR_DEPARTED:
+                    cars[entry.car].departedAt = entry.time;
+                    cars[entry.car].departedFrom = entry.floor;
+                    break;
+                case CAR_ARRIVED: {
+                    // A departure lost to ring overwrite leaves nothing to pair with
+                    CarTrack& track = cars[entry.car];
+                    if (track.departedAt >= 0) {
+                        writer.slice("Run " + std::to_string(track.departedFrom) + " -> " + std::to_string(entry.floor),
+                                     pid, tid, track.departedAt, entry.time, entry.floor);
+                        track.departedAt = -1;
+                    }
+                    break;
+                }
+                case DOORS_OPENED: {
+                    // Reopening before the doors closed continues the same slice
+                    CarTrack& track = cars[entry.car];
+                    if (track.doorsOpenedAt < 0) {
+                        track.doorsOpenedAt = entry.time;
+                        track.doorsFloor = entry.floor;
+                    }
+                    break;
+                }
+                case DOORS_CLOSED: {
+                    CarTrack& track = cars[entry.car];
+                    if (track.doorsOpenedAt >= 0) {
+                        writer.slice("Doors open", pid, tid, track.doorsOpenedAt, entry.time, track.doorsFloor);
+                        track.doorsOpenedAt = -1;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+    writer.finish();
+    
+    if (!out) {
+        throw std::runtime_error("Could not write timeline file: " + path);
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef EVENTTRACE_H
+#define EVENTTRACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Request.h"
+#include "SimClock.h"
+
+// Timeline of what the calls and cars did, stamped with simulated time.
+// Each thread records into its own fixed-size ring, so recording takes no
+// lock and allocates only on a thread's first record; a full ring
+// overwrites its oldest records. The whole recorded timeline can be
+// written as Chrome trace JSON, which chrome://tracing and Perfetto open.
+//
+// Recording goes through TRACE_EVENT, which is compiled in only when
+// ELEVATOR_TRACING is defined (the CMake option of the same name). Even
+// then nothing is recorded until tracing is switched on at run time.
+class EventTrace {
+public:
+    enum Type : std::uint8_t {
+        CALL_REGISTERED, // Hall call (car -1) or car call
+        CALL_ASSIGNED,   // Hall call handed to a car
+        CAR_DEPARTED,    // Floor is where the run starts
+        CAR_ARRIVED,
+        DOORS_OPENED,
+        DOORS_CLOSED
+    };
+    
+    struct Record {
+        SimTime time;
+        std::int32_t floor;
+        std::int16_t car;
+        std::uint8_t type;
+        std::int8_t direction; // Request::Direction of a call
+    };
+    
+    static const std::size_t DEFAULT_CAPACITY = 1 << 20; // Records per thread
+    
+    // Whether TRACE_EVENT records anything in this build
+    static bool isCompiledIn();
+    
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+    
+    // Ring size for threads that have not recorded yet; rounded up to a
+    // power of two
+    static void setCapacity(std::size_t records);
+    
+    static void record(SimTime time, Type type, int car, int floor, int direction = Request::NONE) {
+        if (!enabled.load(std::memory_order_relaxed)) {
+            return;
+        }
+        Ring* ring = localRing ? localRing : attachThread();
+        std::uint64_t head = ring->head.load(std::memory_order_relaxed);
+        Record& entry = ring->records[head & ring->mask];
+        entry.time = time;
+        entry.floor = floor;
+        entry.car = static_cast<std::int16_t>(car);
+        entry.type = type;
+        entry.direction = static_cast<std::int8_t>(direction);
+        ring->head.store(head + 1, std::memory_order_release);
+    }
+    
+    // Records kept and dropped over all threads
+    static std::uint64_t getRecordCount();
+    static std::uint64_t getDroppedCount();
+    
+    // Forget everything recorded so far. The recording threads must be idle.
+    static void clear();
+    
+    // Write every thread's timeline as Chrome trace JSON: one process per
+    // recording thread, one track per car plus one for hall calls. The
+    // recording threads must be idle. Throws std::runtime_error if the
+    // file cannot be written.
+    static void exportChromeTrace(const std::string& path);
+    
+private:
+    struct Ring {
+        std::unique_ptr<Record[]> records;
+        std::uint64_t mask;
+        std::atomic<std::uint64_t> head;
+    };
+    
+    static std::atomic<bool> enabled;
+    // Constant-initialised inline, so reading it needs no TLS wrapper call
+    static inline thread_local Ring* localRing = nullptr;
+    
+    static Ring* attachThread();
+    static std::vector<std::unique_ptr<Ring>>& registry();
+};
+
+#ifdef ELEVATOR_TRACING
+#define TRACE_EVENT(...) EventTrace::record(__VA_ARGS__)
+#else
+#define TRACE_EVENT(...) ((void)0)
+#endif
+
+#endif // EVENTTRACE_H
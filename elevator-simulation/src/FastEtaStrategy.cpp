@@ -0,0 +1,59 @@
+#include "FastEtaStrategy.h"
+#include "DispatchKernel.h"
+
+const char* FastEtaStrategy::getName() const {
+    return "fast-eta";
+}
+
+int FastEtaStrategy::selectElevator(const Request& request, const std::vector<Elevator>& elevators,
+                                    const FleetState& fleet, const std::vector<Floor>& floors, SimTime now,
+                                    float* costs) const {
+    if (elevators.empty()) {
+        return -1;
+    }
+    DispatchKernel::estimate(fleet, request, costs);
+    if (getEnergyWeight() > 0.0) {
+        for (int i = 0; i < fleet.size(); i++) {
+            costs[i] += energyCost(request, elevators[i]);
+        }
+    }
+    
+    // Full cars score infinity; ties go to the lowest-numbered car
+    int best = -1;
+    float bestCost = DispatchKernel::FULL_CAR_COST;
+    for (int i = 0; i < fleet.size(); i++) {
+        if (costs[i] < bestCost) {
+            best = i;
+            bestCost = costs[i];
+        }
+    }
+    if (best < 0) {
+        return -1;
+    }
+    
+    // Cars the estimate cannot tell apart are separated by the delay their
+    // new stop would add to old calls; walking a car's stops for that is
+    // too slow to do for every car
+    float tiedCost = bestCost;
+    int tied = best;
+    double bestDelay = -1.0;
+    for (int i = tied + 1; i < fleet.size(); i++) {
+        if (costs[i] != tiedCost) {
+            continue;
+        }
+        if (bestDelay < 0.0) {
+            bestDelay = delayedCallCost(request, elevators[tied], floors, now);
+        }
+        double delay = delayedCallCost(request, elevators[i], floors, now);
+        if (delay < bestDelay) {
+            best = i;
+            bestDelay = delay;
+        }
+    }
+    return best;
+}
+
+double FastEtaStrategy::cost(const Request& request, const Elevator& elevator,
+                             int numFloors, int /*numElevators*/) const {
+    return DispatchKernel::estimateCar(elevator, request, numFloors);
+}
@@ -0,0 +1,28 @@
+#ifndef FASTETASTRATEGY_H
+#define FASTETASTRATEGY_H
+
+#include "DispatchStrategy.h"
+
+// Estimated time to serve, scored for the whole fleet at once by the
+// vectorised DispatchKernel. It uses a coarser model than EtaStrategy
+// (SCAN distance and stop count instead of the exact stops on the way,
+// timed by each car's own linear fit), which lets a large bank assign
+// bursts of calls with a single pass over the fleet arrays per call. How
+// long other calls have waited only breaks exact ties.
+class FastEtaStrategy : public DispatchStrategy {
+public:
+    const char* getName() const override;
+    
+    // Scores the fleet into scratch
+    int selectElevator(const Request& request, const std::vector<Elevator>& elevators,
+                       const FleetState& fleet, const std::vector<Floor>& floors, SimTime now,
+                       float* scratch) const override;
+                       
+protected:
+    // One car at a time through the kernel's scalar path; selectElevator
+    // scores every car in one kernel call instead
+    double cost(const Request& request, const Elevator& elevator,
+                int numFloors, int numElevators) const override;
+};
+
+#endif // FASTETASTRATEGY_H
@@ -0,0 +1,146 @@
+#include "FleetState.h"
+#include "Request.h"
+#include "StopSet.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+template <typename T>
+void saveArray(BinaryWriter& out, const std::vector<T>& values) {
+    for (T value : values) {
+        out.writeInt64(static_cast<std::int64_t>(value));
+    }
+}
+
+template <typename T>
+void loadArray(BinaryReader& in, std::vector<T>& values) {
+    for (T& value : values) {
+        value = static_cast<T>(in.readInt64());
+    }
+}
+}
+
+FleetState::FleetState(int numFloors)
+    : numFloors(numFloors), wordsPerCar(StopSet::wordsFor(numFloors)) {
+}
+
+int FleetState::addCar(int carCapacity) {
+    currentFloor.push_back(1);
+    targetFloor.push_back(1);
+    direction.push_back(Request::NONE);
+    doorState.push_back(0); // Closed
+    moving.push_back(0);
+    movementStart.push_back(0);
+    arrivalTime.push_back(0);
+    doorOpenedAt.push_back(0);
+    load.push_back(0);
+    capacity.push_back(carCapacity);
+    stopCount.push_back(0);
+    stops.resize(stops.size() + wordsPerCar, 0);
+    secondsPerFloor.push_back(0.0f);
+    secondsPerStop.push_back(0.0f);
+    loadPenalty.push_back(0.0f);
+    return size() - 1;
+}
+
+void FleetState::resetCar(int car) {
+    currentFloor[car] = 1;
+    targetFloor[car] = 1;
+    direction[car] = Request::NONE;
+    doorState[car] = 0;
+    moving[car] = 0;
+    movementStart[car] = 0;
+    arrivalTime[car] = 0;
+    doorOpenedAt[car] = 0;
+    load[car] = 0;
+    stopCount[car] = 0;
+    std::fill(stopWords(car), stopWords(car) + wordsPerCar, 0);
+}
+
+int FleetState::size() const {
+    return currentFloor.size();
+}
+
+std::uint64_t* FleetState::stopWords(int car) {
+    return &stops[car * wordsPerCar];
+}
+
+const std::uint64_t* FleetState::stopWords(int car) const {
+    return &stops[car * wordsPerCar];
+}
+
+void FleetState::save(BinaryWriter& out) const {
+    out.writeInt(numFloors);
+    out.writeInt(size());
+    saveArray(out, currentFloor);
+    saveArray(out, targetFloor);
+    out.writeBytes(direction.data(), direction.size());
+    out.writeBytes(doorState.data(), doorState.size());
+    out.writeBytes(moving.data(), moving.size());
+    saveArray(out, movementStart);
+    saveArray(out, arrivalTime);
+    saveArray(out, doorOpenedAt);
+    saveArray(out, load);
+    saveArray(out, capacity);
+    saveArray(out, stopCount);
+    for (std::uint64_t word : stops) {
+        out.writeUInt64(word);
+    }
+}
+
+void FleetState::restore(BinaryReader& in) {
+    int savedFloors = in.readInt();
+    int savedCars = in.readInt();
+    if (savedFloors != numFloors || savedCars != size()) {
+        throw std::runtime_error("Snapshot is corrupt: fleet does not match the building");
+    }
+    loadArray(in, currentFloor);
+    loadArray(in, targetFloor);
+    in.readBytes(direction.data(), direction.size());
+    in.readBytes(doorState.data(), doorState.size());
+    in.readBytes(moving.data(), moving.size());
+    loadArray(in, movementStart);
+    loadArray(in, arrivalTime);
+    loadArray(in, doorOpenedAt);
+    loadArray(in, load);
+    loadArray(in, capacity);
+    loadArray(in, stopCount);
+    for (std::uint64_t& word : stops) {
+        word = in.readUInt64();
+    }
+    
+    for (int car = 0; car < size(); car++) {
+        if (currentFloor[car] < 1 || currentFloor[car] > numFloors ||
+            targetFloor[car] < 1 || targetFloor[car] > numFloors) {
+            throw std::runtime_error("Snapshot is corrupt: car outside the building");
+        }
+        // A lowered capacity leaves riders aboard, so the load may exceed
+        // it; Elevator::restore checks the load against the riders
+        if (capacity[car] < 1 || load[car] < 0) {
+            throw std::runtime_error("Snapshot is corrupt: car load out of range");
+        }
+        if (direction[car] > Request::NONE) {
+            throw std::runtime_error("Snapshot is corrupt: unknown car direction");
+        }
+        
+        // Bit n is floor n, so only bits 1..numFloors may be set
+        int queued = 0;
+        const std::uint64_t* words = stopWords(car);
+        for (int i = 0; i < wordsPerCar; i++) {
+            std::uint64_t valid = ~std::uint64_t(0);
+            if (i == 0) {
+                valid &= ~std::uint64_t(1);
+            }
+            if (i == wordsPerCar - 1) {
+                valid &= ~std::uint64_t(0) >> (63 - numFloors % 64);
+            }
+            if (words[i] & ~valid) {
+                throw std::runtime_error("Snapshot is corrupt: stop outside the building");
+            }
+            queued += __builtin_popcountll(words[i]);
+        }
+        if (queued != stopCount[car]) {
+            throw std::runtime_error("Snapshot is corrupt: stop count does not match the stops");
+        }
+    }
+}
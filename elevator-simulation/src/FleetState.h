@@ -0,0 +1,56 @@
+#ifndef FLEETSTATE_H
+#define FLEETSTATE_H
+
+#include <cstdint>
+#include <vector>
+#include "BinaryStream.h"
+#include "SimClock.h"
+
+// Hot per-car state for a whole fleet, stored as parallel arrays indexed by
+// car id. Scans over every car (dispatch, rendering) read a few contiguous
+// arrays instead of striding across Elevator objects; for a 64-car fleet
+// each array is at most a few hundred bytes. Elevator objects keep the cold
+// state (riders, run statistics, event bookkeeping) and read and write
+// their own slot here.
+class FleetState {
+public:
+    explicit FleetState(int numFloors);
+    
+    // Append a car parked at floor 1 with its doors closed; returns its id
+    int addCar(int capacity);
+    void resetCar(int car); // Back to floor 1, doors closed, empty; keeps its capacity
+    int size() const;
+    
+    // Stop bitset of a car: wordsPerCar 64-bit words, bit n is floor n
+    std::uint64_t* stopWords(int car);
+    const std::uint64_t* stopWords(int car) const;
+    
+    // Checkpointing; restore expects a fleet of the same size and height
+    void save(BinaryWriter& out) const;
+    void restore(BinaryReader& in);
+    
+    int numFloors;
+    int wordsPerCar;
+    
+    std::vector<int> currentFloor;     // Last floor reached
+    std::vector<int> targetFloor;      // Floor of the current run
+    std::vector<std::uint8_t> direction; // Request::Direction
+    std::vector<std::uint8_t> doorState; // Elevator::DoorState
+    std::vector<std::uint8_t> moving;
+    std::vector<SimTime> movementStart;
+    std::vector<SimTime> arrivalTime;  // End of the current run
+    std::vector<SimTime> doorOpenedAt;
+    std::vector<int> load;
+    std::vector<int> capacity;
+    std::vector<int> stopCount;
+    std::vector<std::uint64_t> stops;  // wordsPerCar words per car
+    
+    // Linear fit of each car's run and door timing for bulk dispatch
+    // estimates (see DispatchKernel::fit). Each car refits its own slot
+    // whenever its settings change, so these are not saved.
+    std::vector<float> secondsPerFloor;
+    std::vector<float> secondsPerStop;
+    std::vector<float> loadPenalty;
+};
+
+#endif // FLEETSTATE_H
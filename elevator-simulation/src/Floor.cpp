@@ -1,31 +1,40 @@
 #include "Floor.h"
 #include "Request.h"
-#include <vector>
+#include <stdexcept>
 
-Floor::Floor(int floorNumber)
-    : floorNumber(floorNumber), upButtonPressed(false), downButtonPressed(false) {
+Floor::Floor(int floorNumber, BlockPool& pool)
+    : floorNumber(floorNumber), upButtonPressed(false), downButtonPressed(false),
+      upCallTime(0), downCallTime(0), waiting(pool) {
 }
 
-void Floor::requestElevator(int direction) {
-    // Create a request and add it to the list
-    Request request(floorNumber, static_cast<Request::Direction>(direction));
-    addRequest(request);
-}
-
-void Floor::addRequest(const Request& request) {
-    requests.push_back(request);
+int Floor::getFloorNumber() const {
+    return floorNumber;
 }
 
-void Floor::clearRequests() {
-    requests.clear();
+bool Floor::pressButton(Request::Direction direction, SimTime now) {
+    if (direction == Request::UP && !upButtonPressed) {
+        upButtonPressed = true;
+        upCallTime = now;
+        return true;
+    }
+    if (direction == Request::DOWN && !downButtonPressed) {
+        downButtonPressed = true;
+        downCallTime = now;
+        return true;
+    }
+    return false;
 }
 
-int Floor::getFloorNumber() const {
-    return floorNumber;
+void Floor::clearCall(Request::Direction direction) {
+    if (direction == Request::UP) {
+        upButtonPressed = false;
+    } else if (direction == Request::DOWN) {
+        downButtonPressed = false;
+    }
 }
 
-const std::vector<Request>& Floor::getRequests() const {
-    return requests;
+bool Floor::hasCall(Request::Direction direction) const {
+    return (direction == Request::UP) ? upButtonPressed : (direction == Request::DOWN && downButtonPressed);
 }
 
 bool Floor::hasUpRequest() const {
@@ -36,18 +45,55 @@ bool Floor::hasDownRequest() const {
     return downButtonPressed;
 }
 
-void Floor::addUpRequest() {
-    upButtonPressed = true;
+SimTime Floor::getCallTime(Request::Direction direction) const {
+    return (direction == Request::UP) ? upCallTime : downCallTime;
 }
 
-void Floor::addDownRequest() {
-    downButtonPressed = true;
+SimTime Floor::getCallAge(Request::Direction direction, SimTime now) const {
+    return hasCall(direction) ? now - getCallTime(direction) : 0;
 }
 
-void Floor::clearUpRequest() {
-    upButtonPressed = false;
+RingQueue& Floor::getWaiting() {
+    return waiting;
 }
 
-void Floor::clearDownRequest() {
+const RingQueue& Floor::getWaiting() const {
+    return waiting;
+}
+
+void Floor::reset() {
+    upButtonPressed = false;
     downButtonPressed = false;
-}
\ No newline at end of file
+    upCallTime = 0;
+    downCallTime = 0;
+    waiting.clear();
+}
+
+void Floor::save(BinaryWriter& out) const {
+    out.writeInt(floorNumber);
+    out.writeBool(upButtonPressed);
+    out.writeInt64(upCallTime);
+    out.writeBool(downButtonPressed);
+    out.writeInt64(downCallTime);
+    out.writeUInt64(waiting.size());
+    for (size_t i = 0; i < waiting.size(); i++) {
+        out.writeInt(waiting[i]);
+    }
+}
+
+void Floor::restore(BinaryReader& in) {
+    if (in.readInt() != floorNumber) {
+        throw std::runtime_error("Snapshot is corrupt: floors out of order");
+    }
+    upButtonPressed = in.readBool();
+    upCallTime = in.readInt64();
+    downButtonPressed = in.readBool();
+    downCallTime = in.readInt64();
+    
+    // Passenger ids are checked by the building once its passengers are back
+    size_t count = in.readCount(1u << 30);
+    waiting.clear();
+    for (size_t i = 0; i < count; i++) {
+        waiting.push(in.readInt());
+    }
+}
@@ -1,29 +1,48 @@
 #ifndef FLOOR_H
 #define FLOOR_H
 
-#include <vector>
+#include "BinaryStream.h"
+#include "BlockPool.h"
 #include "Request.h"
+#include "RingQueue.h"
+#include "SimClock.h"
 
+// One landing: its up and down hall buttons and the passengers waiting
+// there. A button stays latched from the first press until a car answers
+// it, so the time it was pressed tells dispatch how long the call has
+// been waiting.
 class Floor {
 public:
-    Floor(int floorNumber);
-    void requestElevator(int direction);
-    void addRequest(const Request& request);
-    void clearRequests();
+    Floor(int floorNumber, BlockPool& pool);
+    
     int getFloorNumber() const;
-    const std::vector<Request>& getRequests() const;
+    
+    // Returns true if the button was not already lit; a repeated press
+    // keeps the original call time
+    bool pressButton(Request::Direction direction, SimTime now);
+    void clearCall(Request::Direction direction);
+    bool hasCall(Request::Direction direction) const;
     bool hasUpRequest() const;
     bool hasDownRequest() const;
-    void addUpRequest();
-    void addDownRequest();
-    void clearUpRequest();
-    void clearDownRequest();
-
+    SimTime getCallTime(Request::Direction direction) const;          // Only meaningful while lit
+    SimTime getCallAge(Request::Direction direction, SimTime now) const; // 0 if not lit
+    
+    // Ids of the passengers waiting here, in arrival order
+    RingQueue& getWaiting();
+    const RingQueue& getWaiting() const;
+    
+    void reset(); // Buttons off and nobody waiting; the queue keeps its storage
+    
+    void save(BinaryWriter& out) const;
+    void restore(BinaryReader& in); // Into a floor of the same number
+    
 private:
     int floorNumber;
-    std::vector<Request> requests;
     bool upButtonPressed;
     bool downButtonPressed;
+    SimTime upCallTime;
+    SimTime downCallTime;
+    RingQueue waiting;
 };
 
-#endif // FLOOR_H
\ No newline at end of file
+#endif // FLOOR_H
@@ -1,15 +1,55 @@
 #include "GUI.h"
+#include <cmath>
 #include <iostream>
-#include <sstream>
 
-GUI::GUI(sf::RenderWindow& window, Building& building)
-    : window(window), building(building),
+namespace {
+const int BUTTON_SEGMENTS = 12; // Triangles per call button circle
+
+void appendRect(sf::VertexArray& vertices, float x, float y, float width, float height, const sf::Color& color) {
+    sf::Vector2f topLeft(x, y);
+    sf::Vector2f topRight(x + width, y);
+    sf::Vector2f bottomLeft(x, y + height);
+    sf::Vector2f bottomRight(x + width, y + height);
+    vertices.append(sf::Vertex(topLeft, color));
+    vertices.append(sf::Vertex(topRight, color));
+    vertices.append(sf::Vertex(bottomRight, color));
+    vertices.append(sf::Vertex(topLeft, color));
+    vertices.append(sf::Vertex(bottomRight, color));
+    vertices.append(sf::Vertex(bottomLeft, color));
+}
+
+void appendTriangle(sf::VertexArray& vertices, sf::Vector2f a, sf::Vector2f b, sf::Vector2f c, const sf::Color& color) {
+    vertices.append(sf::Vertex(a, color));
+    vertices.append(sf::Vertex(b, color));
+    vertices.append(sf::Vertex(c, color));
+}
+
+void appendCircle(sf::VertexArray& vertices, sf::Vector2f center, float radius, const sf::Color& color) {
+    const float step = 2.0f * 3.14159265f / BUTTON_SEGMENTS;
+    for (int i = 0; i < BUTTON_SEGMENTS; i++) {
+        sf::Vector2f from(center.x + radius * std::cos(i * step), center.y + radius * std::sin(i * step));
+        sf::Vector2f to(center.x + radius * std::cos((i + 1) * step), center.y + radius * std::sin((i + 1) * step));
+        appendTriangle(vertices, center, from, to, color);
+    }
+}
+}
+
+GUI::GUI(sf::RenderWindow& window, SimulationThread& simulation)
+    : window(window), simulation(simulation), snapshot(&simulation.latestSnapshot()),
       inputMode(false), selectedElevator(-1), soundsLoaded(true),
       scaleFactor(1.0f),
       baseFloorHeight(50), baseBuildingWidth(400), baseElevatorWidth(50),
       baseBuildingLeft(200), baseBuildingBottom(650) { // Moved building bottom lower
+    numFloors = snapshot->numFloors;
+    numElevators = snapshot->cars.size();
+    
     // Initialize the previous door states vector
-    prevDoorsOpen.resize(building.getNumElevators(), false);
+    prevDoorsOpen.resize(numElevators, false);
+    
+    staticGeometry.setPrimitiveType(sf::Triangles);
+    carGeometry.setPrimitiveType(sf::Triangles);
+    showCarIds = false;
+    showCarFloors = false;
     
     // Initialize scaled dimensions
     updateScaledDimensions();
@@ -47,6 +87,21 @@ bool GUI::initialize() {
     inputBox.setOutlineThickness(3);
     inputBox.setPosition(window.getSize().x / 2 - 200, window.getSize().y / 2 - 30);
     
+    inputOverlay.setFillColor(sf::Color(0, 0, 0, 180)); // Semi-transparent black
+    modalBox.setFillColor(sf::Color(50, 50, 100, 255)); // Solid color for visibility
+    modalBox.setOutlineColor(sf::Color::White);
+    
+    inputDisplay.setFont(font);
+    inputDisplay.setFillColor(sf::Color::White);
+    inputHelpText.setFont(font);
+    inputHelpText.setFillColor(sf::Color::White);
+    inputHelpText.setString("Press ENTER to confirm or ESC to cancel");
+    layoutInputUI();
+    
+    // Highlight drawn over a hovered floor button
+    buttonHighlight.setRadius(12);
+    buttonHighlight.setFillColor(sf::Color(255, 255, 0, 100)); // Semi-transparent yellow
+    
     // Instructions text
     instructionsText.setFont(font);
     instructionsText.setCharacterSize(20 * scaleFactor);
@@ -95,8 +150,17 @@ void GUI::loadSounds() {
 }
 
 void GUI::adjustToBuildingSize() {
+    // Shrink floors so that tall buildings still fit in the default view
+    baseFloorHeight = std::max(4, std::min(50, 600 / numFloors));
+    
+    // Give each elevator its own slot, widening the building up to a limit
+    // and narrowing the cars after that
+    baseBuildingWidth = std::max(400, std::min(1600, 80 * numElevators));
+    int slotWidth = baseBuildingWidth / (numElevators + 1);
+    baseElevatorWidth = std::max(4, std::min(50, slotWidth * 5 / 8));
+    
     // Adjust window size if needed based on number of floors and elevators
-    int minWindowHeight = building.getNumFloors() * baseFloorHeight + 100; // Extra space for UI elements
+    int minWindowHeight = numFloors * baseFloorHeight + 100; // Extra space for UI elements
     int minWindowWidth = baseBuildingLeft + baseBuildingWidth + 100; // Extra space
     
     // Update window size if needed
@@ -108,18 +172,6 @@ void GUI::adjustToBuildingSize() {
         ));
     }
     
-    // Reset base dimensions if needed
-    if (building.getNumFloors() > 15) {
-        // Reduce floor height for buildings with many floors
-        baseFloorHeight = 800 / building.getNumFloors();
-    }
-    
-    // Adjust building width based on elevator count
-    if (building.getNumElevators() > 5) {
-        // Increase building width for more elevators
-        baseBuildingWidth = std::max(400, 80 * building.getNumElevators());
-    }
-    
     // Update scaled dimensions
     updateScaledDimensions();
 }
@@ -150,6 +202,9 @@ void GUI::updateScaledDimensions() {
     elevatorWidth = static_cast<int>(baseElevatorWidth * scaleFactor);
     buildingLeft = static_cast<int>(baseBuildingLeft * scaleFactor);
     buildingBottom = static_cast<int>(baseBuildingBottom * scaleFactor);
+    
+    // Static geometry is rebuilt on the next frame
+    layoutDirty = true;
 }
 
 bool GUI::handleEvent(sf::Event& event) {
@@ -207,12 +262,7 @@ bool GUI::handleEvent(sf::Event& event) {
                     try {
                         int targetFloor = std::stoi(inputText);
                         
-                        if (targetFloor >= 1 && targetFloor <= building.getNumFloors()) {
-                            // Get elevator reference and add request
-                            auto& elevators = building.getElevators();
-                            const_cast<Elevator&>(elevators[selectedElevator]).addRequest(
-                                Request(targetFloor, Request::NONE));
-                        }
+                        simulation.post({SimCommand::CAR_CALL, targetFloor, selectedElevator, Request::NONE});
                     } catch (const std::exception& e) {
                         std::cerr << "Error processing input: " << e.what() << std::endl;
                     }
@@ -250,7 +300,7 @@ bool GUI::handleEvent(sf::Event& event) {
                 event.key.code <= sf::Keyboard::Num9) {
                 
                 int floor = event.key.code - sf::Keyboard::Num0;
-                if (floor <= building.getNumFloors()) {
+                if (floor <= numFloors) {
                     // First check if there's an elevator already at this floor
                     if (checkElevatorAtFloor(floor)) {
                         // Open doors for all elevators at this floor
@@ -260,29 +310,25 @@ bool GUI::handleEvent(sf::Event& event) {
                         Request::Direction direction = 
                             (event.key.shift) ? Request::DOWN : Request::UP;
                         
-                        building.addRequest(Request(floor, direction));
+                        simulation.post({SimCommand::HALL_CALL, floor, -1, direction});
                     }
                     return true;
                 }
             }
             
-            // Handle function keys for internal requests - support up to 10 elevators with F8-F17
+            // Handle function keys for internal requests - F8-F15 cover the first 8 elevators
             if (event.key.code >= sf::Keyboard::F8 && 
-                event.key.code <= sf::Keyboard::F8 + building.getNumElevators() - 1) {
+                event.key.code <= sf::Keyboard::F8 + std::min(numElevators, 8) - 1) {
                 
                 int elevatorIndex = event.key.code - sf::Keyboard::F8;
-                if (elevatorIndex < building.getNumElevators()) {
+                if (elevatorIndex < numElevators) {
                     // Prompt for floor input
                     int targetFloor;
                     std::cout << "Enter floor for elevator " << (elevatorIndex + 1) << " (1-" 
-                              << building.getNumFloors() << "): ";
+                              << numFloors << "): ";
                     std::cin >> targetFloor;
                     
-                    if (targetFloor >= 1 && targetFloor <= building.getNumFloors()) {
-                        auto& elevators = building.getElevators();
-                        const_cast<Elevator&>(elevators[elevatorIndex]).addRequest(
-                            Request(targetFloor, Request::NONE));
-                    }
+                    simulation.post({SimCommand::CAR_CALL, targetFloor, elevatorIndex, Request::NONE});
                     return true;
                 }
             }
@@ -293,9 +339,9 @@ bool GUI::handleEvent(sf::Event& event) {
 }
 
 bool GUI::checkElevatorAtFloor(int floor) {
-    const auto& elevators = building.getElevators();
-    for (size_t i = 0; i < elevators.size(); i++) {
-        if (elevators[i].getCurrentFloor() == floor && !elevators[i].isMoving() && !elevators[i].doorsOpen()) {
+    const auto& cars = snapshot->cars;
+    for (size_t i = 0; i < cars.size(); i++) {
+        if (cars[i].floor == floor && !cars[i].moving && !cars[i].doorsOpen) {
             return true;
         }
     }
@@ -303,39 +349,24 @@ bool GUI::checkElevatorAtFloor(int floor) {
 }
 
 void GUI::openDoorsForElevatorsAtFloor(int floor) {
-    std::cout << "Looking for an available elevator at floor " << floor << std::endl;
-    
-    const auto& elevators = building.getElevators();
-    bool foundElevator = false;
+    const auto& cars = snapshot->cars;
     
-    // Find the first available elevator at the floor
-    for (size_t i = 0; i < elevators.size(); i++) {
+    // Open the first available elevator at the floor
+    for (size_t i = 0; i < cars.size(); i++) {
         // If elevator is at the requested floor, stationary, and doors are closed
-        if (elevators[i].getCurrentFloor() == floor && 
-            !elevators[i].isMoving() && 
-            !elevators[i].doorsOpen()) {
-            
-            std::cout << "Opening doors for elevator " << (i + 1) << std::endl;
-            
-            // Get a non-const reference and open the doors
-            auto& mutableElevator = const_cast<Elevator&>(elevators[i]);
-            mutableElevator.openDoors();
+        if (cars[i].floor == floor && !cars[i].moving && !cars[i].doorsOpen) {
+            simulation.post({SimCommand::OPEN_DOORS, floor, static_cast<int>(i), Request::NONE});
             
             // Play the door open and ding sounds immediately
-            if (soundsLoaded) {
+            if (soundsLoaded && simulation.isSoundEnabled()) {
                 doorOpenSound.play();
                 elevatorDingSound.play();
             }
             
-            // Only open one elevator's doors, then break the loop
-            foundElevator = true;
-            break;  // Important: Break after handling one elevator
+            // Only open one elevator's doors
+            return;
         }
     }
-    
-    if (!foundElevator) {
-        std::cout << "No available elevators found at floor " << floor << std::endl;
-    }
 }
 
 void GUI::handleElevatorClick(int mouseX, int mouseY) {
@@ -343,20 +374,19 @@ void GUI::handleElevatorClick(int mouseX, int mouseY) {
     sf::Vector2f worldPos = window.mapPixelToCoords(sf::Vector2i(mouseX, mouseY));
     
     // Check if clicked on an elevator
-    const auto& elevators = building.getElevators();
-    for (size_t i = 0; i < elevators.size(); i++) {
+    const auto& cars = snapshot->cars;
+    for (size_t i = 0; i < cars.size(); i++) {
         // Calculate elevator position and bounds
-        float elevatorSpacing = buildingWidth / (elevators.size() + 1);
-        float elevatorX = buildingLeft + elevatorSpacing * (i + 1) - elevatorWidth / 2;
-        float y = buildingBottom - (elevators[i].getCurrentFloor() - 1) * floorHeight - floorHeight;
+        float elevatorX = carLeft(i);
+        float y = buildingBottom - (cars[i].position - 1) * floorHeight - floorHeight;
         
         // Create a rectangle representing the elevator's clickable area
-        sf::FloatRect elevatorBounds(elevatorX, y, elevatorWidth, floorHeight - 10);
+        sf::FloatRect elevatorBounds(elevatorX, y, elevatorWidth, carHeight());
         
         // Check if converted mouse position is within the elevator bounds
         if (elevatorBounds.contains(worldPos)) {
             // Only interact with stationary elevators
-            if (elevators[i].isMoving() || elevators[i].doorsOpen()) {
+            if (cars[i].moving || cars[i].doorsOpen) {
                 continue;
             }
             
@@ -365,6 +395,8 @@ void GUI::handleElevatorClick(int mouseX, int mouseY) {
             selectedElevator = i;
             inputText = "";
             inputBlinkClock.restart();
+            inputPrompt.setString("Enter floor for Elevator " + std::to_string(selectedElevator + 1) +
+                                  " (1-" + std::to_string(numFloors) + "):");
             break;
         }
     }
@@ -380,15 +412,13 @@ void GUI::handleFloorButtonClick(int mouseX, int mouseY) {
         sf::FloatRect buttonBounds = pair.second;
         
         if (buttonBounds.contains(worldPos)) {
-            std::cout << "Floor " << floor << " button clicked" << std::endl;
-            
             // Check if an elevator is already at this floor
             if (checkElevatorAtFloor(floor)) {
                 // Open doors of one elevator at this floor
                 openDoorsForElevatorsAtFloor(floor);
             } else {
                 // No elevator at floor, add normal UP request (could make this smarter later)
-                building.addRequest(Request(floor, Request::UP));
+                simulation.post({SimCommand::HALL_CALL, floor, -1, Request::UP});
             }
             break;
         }
@@ -408,9 +438,28 @@ void GUI::onWindowResize(unsigned int width, unsigned int height) {
     
     // Resize the input box
     inputBox.setSize(sf::Vector2f(400 * scaleFactor, 60 * scaleFactor));
+    layoutInputUI();
+}
+
+void GUI::layoutInputUI() {
+    // Modal dialog centred in the window, scaled with the UI
+    sf::Vector2u size = window.getSize();
+    inputOverlay.setSize(sf::Vector2f(size.x, size.y));
+    modalBox.setSize(sf::Vector2f(500 * scaleFactor, 200 * scaleFactor));
+    modalBox.setOutlineThickness(3 * scaleFactor);
+    modalBox.setPosition(size.x / 2 - 250 * scaleFactor, size.y / 2 - 100 * scaleFactor);
+    
+    inputPrompt.setCharacterSize(static_cast<unsigned int>(24 * scaleFactor));
+    inputDisplay.setCharacterSize(static_cast<unsigned int>(32 * scaleFactor)); // Larger text for better visibility
+    inputDisplay.setPosition(size.x / 2 - 180 * scaleFactor, size.y / 2 - 10 * scaleFactor);
+    inputHelpText.setCharacterSize(static_cast<unsigned int>(18 * scaleFactor));
+    inputHelpText.setPosition(size.x / 2 - 180 * scaleFactor, size.y / 2 + 40 * scaleFactor);
 }
 
 void GUI::update(float deltaTime) {
+    // Pick up the newest state the simulation thread has published
+    snapshot = &simulation.latestSnapshot();
+    
     // Update input mode blink timer
     float blinkTime = inputBlinkClock.getElapsedTime().asSeconds();
     if (blinkTime > 1.0f) {
@@ -422,35 +471,40 @@ void GUI::update(float deltaTime) {
 }
 
 void GUI::playSounds() {
-    const auto& elevators = building.getElevators();
+    const auto& cars = snapshot->cars;
     
     // Make sure the previous doors state vector is properly sized
-    if (prevDoorsOpen.size() != elevators.size()) {
-        prevDoorsOpen.resize(elevators.size(), false);
+    if (prevDoorsOpen.size() != cars.size()) {
+        prevDoorsOpen.resize(cars.size(), false);
     }
     
-    for (size_t i = 0; i < elevators.size(); i++) {
+    bool soundOn = soundsLoaded && simulation.isSoundEnabled();
+    for (size_t i = 0; i < cars.size(); i++) {
         // Play door open sound when doors change from closed to open
-        if (elevators[i].doorsOpen() && !prevDoorsOpen[i] && soundsLoaded) {
+        if (cars[i].doorsOpen && !prevDoorsOpen[i] && soundOn) {
             doorOpenSound.play();
         }
         
         // Play door close sound when doors change from open to closed
-        if (!elevators[i].doorsOpen() && prevDoorsOpen[i] && soundsLoaded) {
+        if (!cars[i].doorsOpen && prevDoorsOpen[i] && soundOn) {
             doorCloseSound.play();
         }
         
         // Play ding sound when elevator arrives at floor (doors opening)
-        if (elevators[i].doorsOpen() && !prevDoorsOpen[i] && soundsLoaded) {
+        if (cars[i].doorsOpen && !prevDoorsOpen[i] && soundOn) {
             elevatorDingSound.play();
         }
         
         // Update previous state
-        prevDoorsOpen[i] = elevators[i].doorsOpen();
+        prevDoorsOpen[i] = cars[i].doorsOpen;
     }
 }
 
 void GUI::render() {
+    if (layoutDirty) {
+        rebuildStaticLayer();
+    }
+    
     window.clear(sf::Color::White);
     
     // Draw scale factor text at the top
@@ -459,9 +513,11 @@ void GUI::render() {
     // Draw instructions
     window.draw(instructionsText);
     
-    // Draw building and elevators
-    drawBuilding();
-    drawFloors();
+    // Draw building, floors and shafts in one batch, then the cars
+    window.draw(staticGeometry);
+    for (const auto& label : floorLabels) {
+        window.draw(label);
+    }
     drawElevators();
     
     // Highlight floor buttons if they're being hovered
@@ -473,11 +529,8 @@ void GUI::render() {
             sf::FloatRect buttonBounds = pair.second;
             
             if (buttonBounds.contains(worldPos)) {
-                // Draw a highlight for the hovered button
-                sf::CircleShape highlight(12);
-                highlight.setFillColor(sf::Color(255, 255, 0, 100)); // Semi-transparent yellow
-                highlight.setPosition(buttonBounds.left - 2, buttonBounds.top - 2);
-                window.draw(highlight);
+                buttonHighlight.setPosition(buttonBounds.left - 2, buttonBounds.top - 2);
+                window.draw(buttonHighlight);
                 break;
             }
         }
@@ -491,23 +544,31 @@ void GUI::render() {
     window.display();
 }
 
-void GUI::drawBuilding() {
-    // Draw building outline
-    sf::RectangleShape buildingOutline(sf::Vector2f(buildingWidth, building.getNumFloors() * floorHeight));
-    buildingOutline.setOutlineColor(sf::Color::Black);
-    buildingOutline.setOutlineThickness(2);
-    buildingOutline.setFillColor(sf::Color(240, 240, 240, 255)); // Light gray
-    buildingOutline.setPosition(buildingLeft, buildingBottom - building.getNumFloors() * floorHeight);
-    window.draw(buildingOutline);
-}
-
-void GUI::drawFloors() {
-    for (int i = 0; i < building.getNumFloors(); i++) {
+void GUI::rebuildStaticLayer() {
+    float buildingTop = buildingBottom - numFloors * floorHeight;
+    
+    staticGeometry.clear();
+    floorLabels.clear();
+    floorButtons.clear();
+    
+    // Building outline (2px border) and fill
+    appendRect(staticGeometry, buildingLeft - 2, buildingTop - 2, buildingWidth + 4, numFloors * floorHeight + 4,
+               sf::Color::Black);
+    appendRect(staticGeometry, buildingLeft, buildingTop, buildingWidth, numFloors * floorHeight,
+               sf::Color(240, 240, 240, 255)); // Light gray
+    
+    // On tall buildings only every few floors get a label and call button
+    int labelStride = std::max(1, (25 + floorHeight - 1) / std::max(1, floorHeight));
+    
+    for (int i = 0; i < numFloors; i++) {
         // Floor line
-        sf::RectangleShape floorLine(sf::Vector2f(buildingWidth, 2));
-        floorLine.setFillColor(sf::Color(150, 150, 150));
-        floorLine.setPosition(buildingLeft, buildingBottom - i * floorHeight);
-        window.draw(floorLine);
+        float lineY = buildingBottom - i * floorHeight;
+        appendRect(staticGeometry, buildingLeft, lineY, buildingWidth, floorHeight > 8 ? 2 : 1,
+                   sf::Color(150, 150, 150));
+        
+        if (i % labelStride != 0) {
+            continue;
+        }
         
         // Floor number
         sf::Text floorNumber;
@@ -515,131 +576,125 @@ void GUI::drawFloors() {
         floorNumber.setString(std::to_string(i + 1));
         floorNumber.setCharacterSize(18);
         floorNumber.setFillColor(sf::Color::Black);
-        floorNumber.setPosition(buildingLeft - 30, buildingBottom - i * floorHeight - 20);
-        window.draw(floorNumber);
+        floorNumber.setPosition(buildingLeft - 30, lineY - 20);
+        floorLabels.push_back(floorNumber);
         
         // Floor call button (single button that calls elevator to this floor)
-        sf::CircleShape callButton(10);
-        callButton.setFillColor(sf::Color(180, 180, 180));
-        callButton.setOutlineColor(sf::Color::Black);
-        callButton.setOutlineThickness(1);
-        callButton.setPosition(buildingLeft - 50, buildingBottom - i * floorHeight - 30 * scaleFactor);
+        // with a 1px outline and a small arrow inside
+        sf::Vector2f buttonCorner(buildingLeft - 50, lineY - 30 * scaleFactor);
+        sf::Vector2f center(buttonCorner.x + 10, buttonCorner.y + 10);
+        appendCircle(staticGeometry, center, 11, sf::Color::Black);
+        appendCircle(staticGeometry, center, 10, sf::Color(180, 180, 180));
         
-        // Store the button position and floor for click detection
-        floorButtons[i] = callButton.getGlobalBounds();
+        sf::Vector2f arrow(buildingLeft - 45, lineY - 27 * scaleFactor);
+        appendTriangle(staticGeometry, arrow, sf::Vector2f(arrow.x + 10, arrow.y), sf::Vector2f(arrow.x + 5, arrow.y + 8),
+                       sf::Color::Black);
         
-        window.draw(callButton);
+        // Store the button position and floor for click detection
+        floorButtons[i] = sf::FloatRect(buttonCorner.x - 1, buttonCorner.y - 1, 22, 22);
+    }
+    
+    // Elevator shafts
+    for (int i = 0; i < numElevators; i++) {
+        appendRect(staticGeometry, carLeft(i) - 5, buildingTop, elevatorWidth + 10, numFloors * floorHeight,
+                   sf::Color(220, 220, 220));
+    }
+    
+    // Per-car labels; the text only changes when a car changes floor. The
+    // ID is shown when the car is large enough to hold it, and the floor
+    // display is skipped when the labels would overlap.
+    float elevatorSpacing = buildingWidth / (numElevators + 1);
+    showCarIds = elevatorWidth >= 20 && floorHeight >= 30;
+    showCarFloors = elevatorSpacing >= 50;
+    
+    carIdLabels.assign(numElevators, sf::Text());
+    carFloorLabels.assign(numElevators, sf::Text());
+    displayedFloors.assign(numElevators, -1);
+    for (int i = 0; i < numElevators; i++) {
+        carIdLabels[i].setFont(font);
+        carIdLabels[i].setString(std::to_string(i + 1));
+        carIdLabels[i].setCharacterSize(18);
+        carIdLabels[i].setFillColor(sf::Color::White);
         
-        // Add a small icon inside button
-        sf::ConvexShape arrow;
-        arrow.setPointCount(3);
-        arrow.setPoint(0, sf::Vector2f(0, 0));
-        arrow.setPoint(1, sf::Vector2f(10, 0));
-        arrow.setPoint(2, sf::Vector2f(5, 8));
-        arrow.setFillColor(sf::Color::Black);
-        arrow.setPosition(buildingLeft - 45, buildingBottom - i * floorHeight - 27 * scaleFactor);
-        window.draw(arrow);
+        carFloorLabels[i].setFont(font);
+        carFloorLabels[i].setCharacterSize(16 * scaleFactor);
+        carFloorLabels[i].setFillColor(sf::Color::Black);
+        carFloorLabels[i].setPosition(carLeft(i) - 5, buildingTop - (20 * scaleFactor));
     }
+    
+    layoutDirty = false;
 }
 
 void GUI::drawElevators() {
-    const auto& elevators = building.getElevators();
-    for (size_t i = 0; i < elevators.size(); i++) {
-        float elevatorSpacing = buildingWidth / (elevators.size() + 1);
-        float elevatorX = buildingLeft + elevatorSpacing * (i + 1) - elevatorWidth / 2;
-        
-        // Elevator shaft
-        sf::RectangleShape elevatorShaft(sf::Vector2f(elevatorWidth + 10, building.getNumFloors() * floorHeight));
-        elevatorShaft.setFillColor(sf::Color(220, 220, 220));
-        elevatorShaft.setPosition(elevatorX - 5, buildingBottom - building.getNumFloors() * floorHeight);
-        window.draw(elevatorShaft);
-        
-        // Elevator car
-        sf::RectangleShape elevatorCar(sf::Vector2f(elevatorWidth, floorHeight - 10));
-        
+    const auto& cars = snapshot->cars;
+    
+    // Every car goes into one vertex array, so the fleet is a single draw call
+    carGeometry.clear();
+    for (size_t i = 0; i < cars.size(); i++) {
         // Color based on state
-        if (elevators[i].doorsOpen()) {
-            elevatorCar.setFillColor(sf::Color::Green);
-        } else if (elevators[i].isMoving()) {
-            elevatorCar.setFillColor(sf::Color::Yellow);
-        } else {
-            elevatorCar.setFillColor(sf::Color::Blue);
+        sf::Color color = sf::Color::Blue;
+        if (cars[i].doorsOpen) {
+            color = sf::Color::Green;
+        } else if (cars[i].moving) {
+            color = sf::Color::Yellow;
         }
         
-        // Position based on current floor
-        float y = buildingBottom - (elevators[i].getCurrentFloor() - 1) * floorHeight - floorHeight;
-        elevatorCar.setPosition(elevatorX, y);
-        window.draw(elevatorCar);
+        // Position along the shaft, fractional while moving
+        float y = buildingBottom - (cars[i].position - 1) * floorHeight - floorHeight;
+        appendRect(carGeometry, carLeft(i), y, elevatorWidth, carHeight(), color);
         
-        // Elevator ID
-        sf::Text elevatorIdText;
-        elevatorIdText.setFont(font);
-        elevatorIdText.setString(std::to_string(i + 1));
-        elevatorIdText.setCharacterSize(18);
-        elevatorIdText.setFillColor(sf::Color::White);
-        elevatorIdText.setPosition(elevatorX + elevatorWidth / 2 - 5, y + floorHeight / 2 - 10);
-        window.draw(elevatorIdText);
+        if (showCarIds) {
+            carIdLabels[i].setPosition(carLeft(i) + elevatorWidth / 2 - 5, y + floorHeight / 2 - 10);
+        }
         
-        // Current floor display above elevator
-        sf::Text floorDisplay;
-        floorDisplay.setFont(font);
-        std::stringstream ss;
-        ss << "At: " << elevators[i].getCurrentFloor();
-        floorDisplay.setString(ss.str());
-        floorDisplay.setCharacterSize(16 * scaleFactor);
-        floorDisplay.setFillColor(sf::Color::Black);
-        floorDisplay.setPosition(elevatorX - 5, buildingBottom - building.getNumFloors() * floorHeight - (20 * scaleFactor));
-        window.draw(floorDisplay);
+        // Current floor display above the shaft
+        int floor = cars[i].floor;
+        if (showCarFloors && floor != displayedFloors[i]) {
+            carFloorLabels[i].setString("At: " + std::to_string(floor));
+            displayedFloors[i] = floor;
+        }
     }
+    window.draw(carGeometry);
+    
+    for (size_t i = 0; i < cars.size(); i++) {
+        if (showCarIds) {
+            window.draw(carIdLabels[i]);
+        }
+        if (showCarFloors) {
+            window.draw(carFloorLabels[i]);
+        }
+    }
+}
+
+float GUI::carLeft(int index) const {
+    // Cars are spread evenly across the building
+    float elevatorSpacing = buildingWidth / (numElevators + 1);
+    return buildingLeft + elevatorSpacing * (index + 1) - elevatorWidth / 2;
+}
+
+int GUI::carHeight() const {
+    // Leave a gap above the car unless floors are too thin for one
+    return floorHeight > 20 ? floorHeight - 10 : std::max(1, floorHeight - 1);
 }
 
 void GUI::drawInputUI() {
-    // Draw semi-transparent overlay for entire screen
-    sf::RectangleShape fullOverlay(sf::Vector2f(window.getSize().x, window.getSize().y));
-    fullOverlay.setFillColor(sf::Color(0, 0, 0, 180)); // Semi-transparent black
-    window.draw(fullOverlay);
-    
-    // Create a more visible modal dialog - scale with the UI scale factor
-    sf::RectangleShape modalBox(sf::Vector2f(500 * scaleFactor, 200 * scaleFactor));
-    modalBox.setFillColor(sf::Color(50, 50, 100, 255)); // Solid color for visibility
-    modalBox.setOutlineColor(sf::Color::White);
-    modalBox.setOutlineThickness(3 * scaleFactor);
-    modalBox.setPosition(window.getSize().x / 2 - 250 * scaleFactor, window.getSize().y / 2 - 100 * scaleFactor);
+    // Semi-transparent overlay for the entire screen, then the modal dialog
+    window.draw(inputOverlay);
     window.draw(modalBox);
-    
-    // Update font sizes for scaled UI
-    inputPrompt.setCharacterSize(static_cast<unsigned int>(24 * scaleFactor));
-    
-    // Update and draw input prompt text
-    inputPrompt.setString("Enter floor for Elevator " + 
-                         std::to_string(selectedElevator + 1) + 
-                         " (1-" + std::to_string(building.getNumFloors()) + "):");
     window.draw(inputPrompt);
     
-    // Draw input text with blinking cursor
-    sf::Text inputDisplay;
-    inputDisplay.setFont(font);
-    
-    // Add blinking cursor
+    // Input text with a blinking cursor; the text is only re-set when it changes
     float blinkTime = inputBlinkClock.getElapsedTime().asSeconds();
     bool showCursor = (blinkTime < 0.5f);
     std::string displayText = inputText;
     if (showCursor) {
         displayText += "_";
     }
-    
-    inputDisplay.setString(displayText);
-    inputDisplay.setCharacterSize(static_cast<unsigned int>(32 * scaleFactor)); // Larger text for better visibility
-    inputDisplay.setFillColor(sf::Color::White);
-    inputDisplay.setPosition(window.getSize().x / 2 - 180 * scaleFactor, window.getSize().y / 2 - 10 * scaleFactor);
+    if (displayText != displayedInput) {
+        inputDisplay.setString(displayText);
+        displayedInput = displayText;
+    }
     window.draw(inputDisplay);
     
-    // Draw help text
-    sf::Text helpText;
-    helpText.setFont(font);
-    helpText.setString("Press ENTER to confirm or ESC to cancel");
-    helpText.setCharacterSize(static_cast<unsigned int>(18 * scaleFactor));
-    helpText.setFillColor(sf::Color::White);
-    helpText.setPosition(window.getSize().x / 2 - 180 * scaleFactor, window.getSize().y / 2 + 40 * scaleFactor);
-    window.draw(helpText);
+    window.draw(inputHelpText);
 }
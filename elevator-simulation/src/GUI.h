@@ -6,13 +6,14 @@
 #include <string>
 #include <vector>
 #include <map>
-#include "Building.h"
-#include "Elevator.h"
 #include "Request.h"
+#include "SimulationThread.h"
 
 class GUI {
 public:
-    GUI(sf::RenderWindow& window, Building& building);
+    // The GUI reads the model only through the simulation's snapshots and
+    // changes it only by posting commands
+    GUI(sf::RenderWindow& window, SimulationThread& simulation);
     ~GUI();
     
     // Initialization methods
@@ -33,9 +34,12 @@ public:
     void adjustToBuildingSize();
     
 private:
-    // Reference to window and building
+    // Reference to window and simulation
     sf::RenderWindow& window;
-    Building& building;
+    SimulationThread& simulation;
+    const SimulationSnapshot* snapshot; // Latest model state, refreshed every frame
+    int numFloors;
+    int numElevators;
     
     // UI scaling factor
     float scaleFactor;
@@ -79,6 +83,28 @@ private:
     
     // Floor buttons for calling elevators
     std::map<int, sf::FloatRect> floorButtons;
+    sf::CircleShape buttonHighlight;
+    
+    // Retained render state. The building, floors, shafts and call buttons
+    // only change with the layout, so they are built once into a vertex
+    // array; cars are batched into a second array each frame, and labels
+    // are only re-set when their value changes.
+    bool layoutDirty;
+    sf::VertexArray staticGeometry;
+    std::vector<sf::Text> floorLabels;
+    sf::VertexArray carGeometry;
+    std::vector<sf::Text> carIdLabels;
+    std::vector<sf::Text> carFloorLabels;
+    std::vector<int> displayedFloors;
+    bool showCarIds;
+    bool showCarFloors;
+    
+    // Input modal
+    sf::RectangleShape inputOverlay;
+    sf::RectangleShape modalBox;
+    sf::Text inputDisplay;
+    sf::Text inputHelpText;
+    std::string displayedInput;
     
     // Helper methods
     void handleElevatorClick(int mouseX, int mouseY);
@@ -86,11 +112,13 @@ private:
     void onWindowResize(unsigned int width, unsigned int height);
     void loadSounds();
     void playSounds();
-    void drawBuilding();
-    void drawFloors();
+    void rebuildStaticLayer();
     void drawElevators();
     void drawInputUI();
+    void layoutInputUI();
     void updateScaledDimensions();
+    int carHeight() const;
+    float carLeft(int index) const;
     bool checkElevatorAtFloor(int floor);
     void openDoorsForElevatorsAtFloor(int floor);
 };
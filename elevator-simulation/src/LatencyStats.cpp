@@ -0,0 +1,151 @@
+#include "LatencyStats.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+LatencyStats::LatencyStats() : buckets(BUCKETS, 0), samples(0), average(0.0), squares(0.0), maxValue(0.0) {
+}
+
+int LatencyStats::bucketOf(double seconds) {
+    double millis = std::round(seconds * 1000.0);
+    std::uint64_t value = (millis > 0.0) ? static_cast<std::uint64_t>(std::min(millis, double(MAX_MILLIS))) : 0;
+    if (value < 2 * SUB_BUCKETS) {
+        return static_cast<int>(value);
+    }
+    
+    // The top SUB_BUCKET_BITS + 1 bits pick the bucket within the power of two
+    int shift = 63 - __builtin_clzll(value) - SUB_BUCKET_BITS;
+    int sub = static_cast<int>(value >> shift) - SUB_BUCKETS;
+    return 2 * SUB_BUCKETS + (shift - 1) * SUB_BUCKETS + sub;
+}
+
+double LatencyStats::valueOf(int bucket) {
+    if (bucket < 2 * SUB_BUCKETS) {
+        return bucket / 1000.0;
+    }
+    
+    int shift = (bucket - 2 * SUB_BUCKETS) / SUB_BUCKETS + 1;
+    std::uint64_t low = std::uint64_t((bucket - 2 * SUB_BUCKETS) % SUB_BUCKETS + SUB_BUCKETS) << shift;
+    std::uint64_t width = std::uint64_t(1) << shift;
+    return (low + (width - 1) / 2.0) / 1000.0;
+}
+
+void LatencyStats::add(double seconds) {
+    buckets[bucketOf(seconds)]++;
+    maxValue = (samples == 0) ? seconds : std::max(maxValue, seconds);
+    
+    // Welford's update keeps the deviations exact without storing samples
+    samples++;
+    double delta = seconds - average;
+    average += delta / samples;
+    squares += delta * (seconds - average);
+}
+
+void LatencyStats::clear() {
+    std::fill(buckets.begin(), buckets.end(), 0);
+    samples = 0;
+    average = 0.0;
+    squares = 0.0;
+    maxValue = 0.0;
+}
+
+void LatencyStats::merge(const LatencyStats& other) {
+    if (other.samples == 0) {
+        return;
+    }
+    if (samples == 0) {
+        *this = other;
+        return;
+    }
+    
+    for (int i = 0; i < BUCKETS; i++) {
+        buckets[i] += other.buckets[i];
+    }
+    
+    // Combine the two averages and deviation sums (Chan et al.)
+    std::uint64_t total = samples + other.samples;
+    double delta = other.average - average;
+    squares += other.squares + delta * delta * (double(samples) * other.samples / total);
+    average += delta * other.samples / total;
+    samples = total;
+    maxValue = std::max(maxValue, other.maxValue);
+}
+
+size_t LatencyStats::count() const {
+    return samples;
+}
+
+double LatencyStats::mean() const {
+    return average;
+}
+
+double LatencyStats::max() const {
+    return maxValue;
+}
+
+double LatencyStats::stddev() const {
+    if (samples < 2) {
+        return 0.0;
+    }
+    return std::sqrt(std::max(squares, 0.0) / (samples - 1));
+}
+
+double LatencyStats::percentile(double p) const {
+    if (samples == 0) {
+        return 0.0;
+    }
+    
+    // Nearest rank: the smallest sample with at least p% of samples at or below it
+    p = std::max(0.0, std::min(p, 100.0));
+    std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(p / 100.0 * samples));
+    if (rank == 0) {
+        rank = 1;
+    }
+    
+    std::uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(valueOf(i), maxValue);
+        }
+    }
+    return maxValue;
+}
+
+void LatencyStats::save(BinaryWriter& out) const {
+    out.writeUInt64(samples);
+    out.writeDouble(average);
+    out.writeDouble(squares);
+    out.writeDouble(maxValue);
+    
+    // Only the buckets in use, as index and count
+    out.writeUInt64(std::count_if(buckets.begin(), buckets.end(), [](std::uint64_t n) { return n != 0; }));
+    for (int i = 0; i < BUCKETS; i++) {
+        if (buckets[i] != 0) {
+            out.writeInt(i);
+            out.writeUInt64(buckets[i]);
+        }
+    }
+}
+
+void LatencyStats::restore(BinaryReader& in) {
+    clear();
+    samples = in.readUInt64();
+    average = in.readDouble();
+    squares = in.readDouble();
+    maxValue = in.readDouble();
+    
+    size_t used = in.readCount(BUCKETS);
+    std::uint64_t counted = 0;
+    for (size_t i = 0; i < used; i++) {
+        int bucket = in.readInt();
+        if (bucket < 0 || bucket >= BUCKETS) {
+            throw std::runtime_error("Snapshot is corrupt: latency bucket out of range");
+        }
+        buckets[bucket] = in.readUInt64();
+        counted += buckets[bucket];
+    }
+    if (counted != samples) {
+        throw std::runtime_error("Snapshot is corrupt: latency buckets do not add up");
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef LATENCYSTATS_H
+#define LATENCYSTATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BinaryStream.h"
+
+// Collects latency samples (in seconds) and reports their distribution.
+// Samples are counted in a fixed log-linear histogram, so adding one never
+// allocates however long a run goes on. Percentiles are exact to the
+// millisecond below half a second and within 0.2% above it; count, mean,
+// standard deviation and maximum are exact.
+class LatencyStats {
+public:
+    LatencyStats();
+    
+    void add(double seconds);
+    void clear();
+    
+    // Add every sample of another collection
+    void merge(const LatencyStats& other);
+    
+    size_t count() const;
+    double mean() const;
+    double max() const;
+    double stddev() const; // Sample standard deviation
+    
+    // Nearest-rank percentile, p in [0, 100]
+    double percentile(double p) const;
+    
+    void save(BinaryWriter& out) const;
+    void restore(BinaryReader& in);
+    
+private:
+    // Milliseconds below 2 * SUB_BUCKETS have a bucket each; above that,
+    // every power of two is split into SUB_BUCKETS buckets. Samples beyond
+    // MAX_MILLIS (about 49 days) go in the last bucket.
+    static const int SUB_BUCKETS = 256;
+    static const int SUB_BUCKET_BITS = 8;
+    static const std::uint64_t MAX_MILLIS = (std::uint64_t(1) << 32) - 1;
+    static const int BUCKETS = 2 * SUB_BUCKETS + (32 - SUB_BUCKET_BITS - 1) * SUB_BUCKETS;
+    
+    static int bucketOf(double seconds);
+    static double valueOf(int bucket); // Middle of the bucket, in seconds
+    
+    std::vector<std::uint64_t> buckets; // Sized once, in the constructor
+    std::uint64_t samples;
+    double average;
+    double squares; // Sum of squared deviations from the average
+    double maxValue;
+};
+
+#endif // LATENCYSTATS_H
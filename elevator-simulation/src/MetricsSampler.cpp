@@ -0,0 +1,156 @@
+#include "MetricsSampler.h"
+#include "Building.h"
+#include "EnergyModel.h"
+#include "MetricsWriter.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+// Columns before the per-car and per-floor ones
+const int BUILDING_COLUMNS = 6;
+const int CAR_COLUMNS = 5;
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+}
+
+std::unique_ptr<MetricsSink> MetricsSink::openFile(const std::string& path) {
+    if (endsWith(path, ".csv")) {
+        return std::unique_ptr<MetricsSink>(new CsvMetricsWriter(path));
+    }
+    return std::unique_ptr<MetricsSink>(new ColumnarMetricsWriter(path));
+}
+
+MetricsSampler::MetricsSampler(SimTime interval) : interval(interval), lastTime(0), samplesTaken(0) {
+    if (interval <= 0) {
+        throw std::invalid_argument("Metrics interval must be positive");
+    }
+}
+
+void MetricsSampler::addSink(std::unique_ptr<MetricsSink> sink) {
+    sinks.push_back(std::move(sink));
+}
+
+SimTime MetricsSampler::getInterval() const {
+    return interval;
+}
+
+void MetricsSampler::start(const Building& building) {
+    columns.clear();
+    columns.push_back({"time_s", "elevator_sim_time_seconds", "", "Simulated time of the sample", false});
+    columns.push_back({"passengers_served", "elevator_passengers_served_total", "",
+                       "Passengers delivered to their destination", true});
+    columns.push_back({"passengers_waiting", "elevator_passengers_waiting", "",
+                       "Passengers waiting at all floors", false});
+    columns.push_back({"hall_calls", "elevator_hall_calls", "", "Hall buttons lit", false});
+    columns.push_back({"oldest_call_s", "elevator_oldest_hall_call_seconds", "",
+                       "Time since the oldest lit hall button was pressed", false});
+    columns.push_back({"oldest_wait_s", "elevator_oldest_wait_seconds", "",
+                       "Wait so far of the passenger who has waited longest", false});
+    
+    for (const auto& elevator : building.getElevators()) {
+        std::string car = std::to_string(elevator.getId() + 1);
+        std::string labels = "car=\"" + car + "\"";
+        columns.push_back({"car" + car + "_utilisation", "elevator_car_utilisation", labels,
+                           "Share of the last interval the car was moving or had its doors open", false});
+        columns.push_back({"car" + car + "_load", "elevator_car_load", labels, "Passengers in the car", false});
+        columns.push_back({"car" + car + "_floor", "elevator_car_position_floors", labels,
+                           "Position of the car in floors", false});
+        // Drawn and regenerated energy each only grow; their difference,
+        // the net energy, does not
+        columns.push_back({"car" + car + "_drawn_kwh", "elevator_car_drawn_energy_kwh_total", labels,
+                           "Energy drawn by the car's drive, doors and controller", true});
+        columns.push_back({"car" + car + "_regenerated_kwh", "elevator_car_regenerated_energy_kwh_total", labels,
+                           "Energy fed back by the car's drive", true});
+    }
+    for (const auto& floor : building.getFloors()) {
+        std::string number = std::to_string(floor.getFloorNumber());
+        columns.push_back({"floor" + number + "_waiting", "elevator_floor_waiting", "floor=\"" + number + "\"",
+                           "Passengers waiting at the floor", false});
+    }
+    row.assign(columns.size(), 0.0);
+    
+    lastTime = building.getClock().now();
+    lastServiceTime.clear();
+    for (const auto& elevator : building.getElevators()) {
+        lastServiceTime.push_back(elevator.getServiceTime());
+    }
+    for (auto& sink : sinks) {
+        sink->begin(columns);
+    }
+}
+
+void MetricsSampler::sample(const Building& building) {
+    if (row.empty()) {
+        throw std::logic_error("Metrics sampler used before start");
+    }
+    
+    SimTime now = building.getClock().now();
+    const std::vector<Passenger>& passengers = building.getPassengers();
+    int waiting = 0;
+    int hallCalls = 0;
+    SimTime oldestCall = 0;
+    SimTime oldestWait = 0;
+    size_t numCars = lastServiceTime.size();
+    double* floorValues = row.data() + BUILDING_COLUMNS + CAR_COLUMNS * numCars;
+    for (const auto& floor : building.getFloors()) {
+        const RingQueue& queue = floor.getWaiting();
+        waiting += queue.size();
+        hallCalls += floor.hasUpRequest() + floor.hasDownRequest();
+        oldestCall = std::max({oldestCall, floor.getCallAge(Request::UP, now), floor.getCallAge(Request::DOWN, now)});
+        if (!queue.empty()) {
+            // Queues are in arrival order
+            oldestWait = std::max(oldestWait, now - passengers[queue.front()].getSpawnTime());
+        }
+        *floorValues++ = queue.size();
+    }
+    
+    row[0] = SimClock::toSeconds(now);
+    row[1] = building.getPassengersServed();
+    row[2] = waiting;
+    row[3] = hallCalls;
+    row[4] = SimClock::toSeconds(oldestCall);
+    row[5] = SimClock::toSeconds(oldestWait);
+    
+    SimTime elapsed = now - lastTime;
+    double* carValues = row.data() + BUILDING_COLUMNS;
+    for (size_t i = 0; i < numCars; i++) {
+        const Elevator& elevator = building.getElevators()[i];
+        SimTime service = elevator.getServiceTime();
+        SimTime& last = lastServiceTime[i];
+        *carValues++ = (elapsed > 0) ? static_cast<double>(service - last) / elapsed : 0.0;
+        *carValues++ = elevator.getLoad();
+        *carValues++ = elevator.getPosition();
+        Elevator::EnergyUse energy = elevator.getEnergyUse();
+        *carValues++ = EnergyModel::toKWh(energy.motor + energy.doors + energy.standby);
+        *carValues++ = EnergyModel::toKWh(energy.regenerated);
+        last = service;
+    }
+    lastTime = now;
+    
+    for (auto& sink : sinks) {
+        sink->write(row.data());
+    }
+    samplesTaken++;
+}
+
+void MetricsSampler::flush() {
+    for (auto& sink : sinks) {
+        sink->flush();
+    }
+}
+
+void MetricsSampler::close() {
+    for (auto& sink : sinks) {
+        sink->close();
+    }
+}
+
+const std::vector<MetricsColumn>& MetricsSampler::getColumns() const {
+    return columns;
+}
+
+long MetricsSampler::getSamplesTaken() const {
+    return samplesTaken;
+}
@@ -0,0 +1,82 @@
+#ifndef METRICSSAMPLER_H
+#define METRICSSAMPLER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "SimClock.h"
+
+class Building;
+
+// One measured quantity of a sample
+struct MetricsColumn {
+    std::string name;   // Column name in files, e.g. "car2_load"
+    std::string metric; // Prometheus metric name, e.g. "elevator_car_load"
+    std::string labels; // Prometheus labels, e.g. car="2"; empty for the whole building
+    const char* help;
+    bool counter;       // Only ever grows during a run
+};
+
+// Where samples go: a file writer or the Prometheus endpoint. begin is
+// called once with the columns, then write once per sample with one value
+// per column.
+class MetricsSink {
+public:
+    virtual ~MetricsSink() = default;
+    
+    virtual void begin(const std::vector<MetricsColumn>& columns) = 0;
+    virtual void write(const double* row) = 0;
+    virtual void flush() = 0;
+    
+    // Write out everything and close the output, throwing if any of it
+    // could not be written. Destroying a sink that was not closed writes
+    // what it can but cannot report a failure.
+    virtual void close() = 0;
+    
+    // Writer for a metrics file: CSV if the name ends in ".csv", otherwise
+    // the columnar binary format (see ColumnarMetricsWriter)
+    static std::unique_ptr<MetricsSink> openFile(const std::string& path);
+};
+
+// Samples a building's operating metrics every interval of simulated time
+// and passes each sample to its sinks:
+// - per car: share of the interval spent in service, load, position, and
+//   energy drawn and regenerated so far
+// - per floor: passengers waiting
+// - building-wide: passengers served, passengers waiting, lit hall calls,
+//   age of the oldest hall call and wait of the longest-waiting passenger
+// Attach it with Building::setSampler; the building then calls sample()
+// as simulated time passes each multiple of the interval.
+class MetricsSampler {
+public:
+    static constexpr double DEFAULT_INTERVAL_SECONDS = 10.0;
+    
+    explicit MetricsSampler(SimTime interval);
+    
+    void addSink(std::unique_ptr<MetricsSink> sink);
+    SimTime getInterval() const;
+    
+    // Fix the columns for this building and take the reference point for
+    // the first interval; called by Building::setSampler. Cars added
+    // later are not sampled.
+    void start(const Building& building);
+    void sample(const Building& building);
+    void flush();
+    void close(); // Closes every sink; no samples may follow
+    
+    const std::vector<MetricsColumn>& getColumns() const;
+    long getSamplesTaken() const;
+    
+private:
+    SimTime interval;
+    std::vector<std::unique_ptr<MetricsSink>> sinks;
+    std::vector<MetricsColumn> columns;
+    std::vector<double> row;
+    
+    // State at the previous sample, for per-interval figures
+    SimTime lastTime;
+    std::vector<SimTime> lastServiceTime;
+    long samplesTaken;
+};
+
+#endif // METRICSSAMPLER_H
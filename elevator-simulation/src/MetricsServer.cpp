@@ -0,0 +1,158 @@
+#include "MetricsServer.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+const int POLL_MILLISECONDS = 200; // How quickly the server notices it should stop
+
+#ifdef MSG_NOSIGNAL
+const int SEND_FLAGS = MSG_NOSIGNAL; // A client hanging up must not kill the process
+#else
+const int SEND_FLAGS = 0;
+#endif
+
+void sendAll(int connection, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t count = send(connection, data.data() + sent, data.size() - sent, SEND_FLAGS);
+        if (count <= 0) {
+            return;
+        }
+        sent += count;
+    }
+}
+}
+
+MetricsServer::MetricsServer(int requestedPort) : listener(-1), port(requestedPort), running(false) {
+    if (requestedPort < 0 || requestedPort > 65535) {
+        throw std::invalid_argument("Metrics port must be between 0 and 65535");
+    }
+    
+    listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0) {
+        throw std::runtime_error("Could not open the metrics socket");
+    }
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    
+    // Only reachable from this machine
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<std::uint16_t>(requestedPort));
+    socklen_t length = sizeof(address);
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listener, 8) < 0 ||
+        getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) < 0) {
+        ::close(listener);
+        throw std::runtime_error("Could not listen for metrics on port " + std::to_string(requestedPort));
+    }
+    port = ntohs(address.sin_port);
+    
+    running = true;
+    worker = std::thread(&MetricsServer::serve, this);
+}
+
+MetricsServer::~MetricsServer() {
+    running = false;
+    if (worker.joinable()) {
+        worker.join();
+    }
+    ::close(listener);
+}
+
+void MetricsServer::begin(const std::vector<MetricsColumn>& newColumns) {
+    columns = newColumns;
+    groups.clear();
+    for (size_t i = 0; i < columns.size(); i++) {
+        size_t group = 0;
+        while (group < groups.size() && columns[groups[group][0]].metric != columns[i].metric) {
+            group++;
+        }
+        if (group == groups.size()) {
+            groups.emplace_back();
+        }
+        groups[group].push_back(i);
+    }
+}
+
+void MetricsServer::write(const double* row) {
+    page.clear();
+    char value[32];
+    for (const auto& group : groups) {
+        const MetricsColumn& first = columns[group[0]];
+        page += "# HELP " + first.metric + " " + first.help + "\n";
+        page += "# TYPE " + first.metric + (first.counter ? " counter\n" : " gauge\n");
+        for (size_t i : group) {
+            page += columns[i].metric;
+            if (!columns[i].labels.empty()) {
+                page += "{" + columns[i].labels + "}";
+            }
+            std::snprintf(value, sizeof(value), " %.10g\n", row[i]);
+            page += value;
+        }
+    }
+    
+    std::lock_guard<std::mutex> guard(pageLock);
+    published.swap(page);
+}
+
+void MetricsServer::flush() {
+}
+
+void MetricsServer::close() {
+}
+
+int MetricsServer::getPort() const {
+    return port;
+}
+
+void MetricsServer::serve() {
+    while (running) {
+        pollfd waiting = {listener, POLLIN, 0};
+        if (poll(&waiting, 1, POLL_MILLISECONDS) <= 0) {
+            continue;
+        }
+        int connection = accept(listener, nullptr, nullptr);
+        if (connection < 0) {
+            continue;
+        }
+        answer(connection);
+        ::close(connection);
+    }
+}
+
+void MetricsServer::answer(int connection) {
+    // A client that never sends its request cannot hold the server up
+    timeval timeout = {1, 0};
+    setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    
+    char request[1024];
+    ssize_t count = recv(connection, request, sizeof(request) - 1, 0);
+    if (count <= 0) {
+        return;
+    }
+    request[count] = '\0';
+    
+    std::string body;
+    const char* status = "200 OK";
+    if (std::strncmp(request, "GET /metrics ", 13) == 0 || std::strncmp(request, "GET /metrics?", 13) == 0) {
+        std::lock_guard<std::mutex> guard(pageLock);
+        body = published;
+    } else {
+        status = "404 Not Found";
+        body = "Metrics are at /metrics\n";
+    }
+    sendAll(connection, std::string("HTTP/1.1 ") + status + "\r\n"
+                        "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                        "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                        "Connection: close\r\n\r\n" + body);
+}
@@ -0,0 +1,51 @@
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MetricsSampler.h"
+
+// Serves the latest sample in the Prometheus text format over HTTP on
+// 127.0.0.1, at /metrics. The simulation hands each sample over as a
+// finished page; a scrape only copies the page under a lock, so scrapes
+// never wait for the simulation and the simulation never waits for the
+// network.
+class MetricsServer : public MetricsSink {
+public:
+    // Port 0 picks a free port; see getPort
+    explicit MetricsServer(int port);
+    ~MetricsServer() override;
+    
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+    
+    void begin(const std::vector<MetricsColumn>& columns) override;
+    void write(const double* row) override;
+    void flush() override;
+    void close() override; // Nothing to write; keeps serving the last page
+    
+    int getPort() const;
+    
+private:
+    int listener;
+    int port;
+    std::atomic<bool> running;
+    std::thread worker;
+    
+    // Columns grouped by metric, since Prometheus wants all samples of a
+    // metric together
+    std::vector<MetricsColumn> columns;
+    std::vector<std::vector<size_t>> groups;
+    std::string page; // Being built from the latest sample
+    
+    std::mutex pageLock;
+    std::string published;
+    
+    void serve();
+    void answer(int connection);
+};
+
+#endif // METRICSSERVER_H
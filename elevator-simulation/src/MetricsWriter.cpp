@@ -0,0 +1,189 @@
+#include "MetricsWriter.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+const char MAGIC[4] = {'E', 'L', 'V', 'M'};
+
+void putLittleEndian(char* data, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        data[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+}
+
+CsvMetricsWriter::CsvMetricsWriter(const std::string& path)
+    : file(std::fopen(path.c_str(), "w")), buffer(BUFFER_SIZE), used(0), numColumns(0) {
+    if (!file) {
+        throw std::runtime_error("Could not create metrics file: " + path);
+    }
+}
+
+CsvMetricsWriter::~CsvMetricsWriter() {
+    if (!file) {
+        return;
+    }
+    
+    // Best effort: a destructor must not throw
+    if (used > 0) {
+        std::fwrite(buffer.data(), 1, used, file);
+    }
+    std::fclose(file);
+}
+
+void CsvMetricsWriter::begin(const std::vector<MetricsColumn>& columns) {
+    numColumns = columns.size();
+    for (size_t i = 0; i < columns.size(); i++) {
+        if (i > 0) {
+            append(",", 1);
+        }
+        append(columns[i].name.data(), columns[i].name.size());
+    }
+    append("\n", 1);
+}
+
+void CsvMetricsWriter::write(const double* row) {
+    if (!file) {
+        throw std::logic_error("Metrics file is already closed");
+    }
+    char text[32];
+    for (size_t i = 0; i < numColumns; i++) {
+        int length = std::snprintf(text, sizeof(text), i > 0 ? ",%.6g" : "%.6g", row[i]);
+        append(text, length);
+    }
+    append("\n", 1);
+}
+
+void CsvMetricsWriter::flush() {
+    if (!file) {
+        return;
+    }
+    if (used > 0 && std::fwrite(buffer.data(), 1, used, file) != used) {
+        throw std::runtime_error("Failed to write metrics file");
+    }
+    used = 0;
+    std::fflush(file);
+}
+
+void CsvMetricsWriter::close() {
+    if (!file) {
+        return;
+    }
+    
+    flush();
+    std::FILE* closing = file;
+    file = nullptr;
+    if (std::fclose(closing) != 0) {
+        throw std::runtime_error("Failed to write metrics file");
+    }
+}
+
+void CsvMetricsWriter::append(const char* text, size_t length) {
+    if (used + length > buffer.size()) {
+        flush();
+    }
+    if (length > buffer.size()) {
+        // A header longer than the whole buffer goes straight out
+        if (std::fwrite(text, 1, length, file) != length) {
+            throw std::runtime_error("Failed to write metrics file");
+        }
+        return;
+    }
+    std::memcpy(buffer.data() + used, text, length);
+    used += length;
+}
+
+ColumnarMetricsWriter::ColumnarMetricsWriter(const std::string& path)
+    : file(std::fopen(path.c_str(), "wb")), numColumns(0), rows(0) {
+    if (!file) {
+        throw std::runtime_error("Could not create metrics file: " + path);
+    }
+}
+
+ColumnarMetricsWriter::~ColumnarMetricsWriter() {
+    if (!file) {
+        return;
+    }
+    
+    // Best effort: a destructor must not throw
+    try {
+        flush();
+    } catch (const std::exception&) {
+    }
+    std::fclose(file);
+}
+
+void ColumnarMetricsWriter::begin(const std::vector<MetricsColumn>& columns) {
+    numColumns = columns.size();
+    values.assign(numColumns * ROWS_PER_BLOCK, 0.0);
+    encoded.resize(numColumns * ROWS_PER_BLOCK * 8);
+    
+    char header[12];
+    std::memcpy(header, MAGIC, 4);
+    putLittleEndian(header + 4, VERSION, 4);
+    putLittleEndian(header + 8, numColumns, 4);
+    writeBytes(header, sizeof(header));
+    for (const auto& column : columns) {
+        char length[4];
+        putLittleEndian(length, column.name.size(), 4);
+        writeBytes(length, sizeof(length));
+        writeBytes(column.name.data(), column.name.size());
+    }
+}
+
+void ColumnarMetricsWriter::write(const double* row) {
+    if (!file) {
+        throw std::logic_error("Metrics file is already closed");
+    }
+    for (size_t i = 0; i < numColumns; i++) {
+        values[i * ROWS_PER_BLOCK + rows] = row[i];
+    }
+    rows++;
+    if (rows == ROWS_PER_BLOCK) {
+        flush();
+    }
+}
+
+void ColumnarMetricsWriter::flush() {
+    if (!file) {
+        return;
+    }
+    if (rows > 0) {
+        char count[4];
+        putLittleEndian(count, rows, 4);
+        writeBytes(count, sizeof(count));
+        
+        // Only the filled part of each column is written
+        char* data = encoded.data();
+        for (size_t i = 0; i < numColumns; i++) {
+            for (size_t r = 0; r < rows; r++) {
+                std::uint64_t bits;
+                std::memcpy(&bits, &values[i * ROWS_PER_BLOCK + r], sizeof(bits));
+                putLittleEndian(data, bits, 8);
+                data += 8;
+            }
+        }
+        writeBytes(encoded.data(), data - encoded.data());
+        rows = 0;
+    }
+    std::fflush(file);
+}
+
+void ColumnarMetricsWriter::close() {
+    if (!file) {
+        return;
+    }
+    
+    flush();
+    std::FILE* closing = file;
+    file = nullptr;
+    if (std::fclose(closing) != 0) {
+        throw std::runtime_error("Failed to write metrics file");
+    }
+}
+
+void ColumnarMetricsWriter::writeBytes(const void* data, size_t size) {
+    if (std::fwrite(data, 1, size, file) != size) {
+        throw std::runtime_error("Failed to write metrics file");
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef METRICSWRITER_H
+#define METRICSWRITER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "MetricsSampler.h"
+
+// Writes samples as CSV, one row per sample under a header of column
+// names, through a fixed-size buffer
+class CsvMetricsWriter : public MetricsSink {
+public:
+    static const size_t BUFFER_SIZE = 64 * 1024;
+    
+    explicit CsvMetricsWriter(const std::string& path);
+    ~CsvMetricsWriter() override;
+    
+    CsvMetricsWriter(const CsvMetricsWriter&) = delete;
+    CsvMetricsWriter& operator=(const CsvMetricsWriter&) = delete;
+    
+    void begin(const std::vector<MetricsColumn>& columns) override;
+    void write(const double* row) override;
+    void flush() override;
+    void close() override;
+    
+private:
+    std::FILE* file; // Null once closed
+    std::vector<char> buffer;
+    size_t used;
+    size_t numColumns;
+    
+    void append(const char* text, size_t length);
+};
+
+// Writes samples column by column in blocks of rows, so a reader can load
+// one metric without decoding the others and memory use does not depend
+// on the length of the run.
+//
+// Format: the magic "ELVM", a little-endian uint32 version, a uint32
+// column count and each column name as a uint32 length and its bytes.
+// Then blocks until the end of the file: a uint32 row count n, followed
+// by n float64 values of the first column, n of the second, and so on.
+class ColumnarMetricsWriter : public MetricsSink {
+public:
+    static const std::uint32_t VERSION = 1;
+    static const size_t ROWS_PER_BLOCK = 1024;
+    
+    explicit ColumnarMetricsWriter(const std::string& path);
+    ~ColumnarMetricsWriter() override;
+    
+    ColumnarMetricsWriter(const ColumnarMetricsWriter&) = delete;
+    ColumnarMetricsWriter& operator=(const ColumnarMetricsWriter&) = delete;
+    
+    void begin(const std::vector<MetricsColumn>& columns) override;
+    void write(const double* row) override;
+    void flush() override; // Ends the current block
+    void close() override;
+    
+private:
+    std::FILE* file; // Null once closed
+    size_t numColumns;
+    size_t rows;                 // In the current block
+    std::vector<double> values;  // ROWS_PER_BLOCK per column
+    std::vector<char> encoded;
+    
+    void writeBytes(const void* data, size_t size);
+};
+
+#endif // METRICSWRITER_H
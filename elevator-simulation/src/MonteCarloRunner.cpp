@@ -0,0 +1,213 @@
+#include "MonteCarloRunner.h"
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include "Checkpoint.h"
+#include "DispatchStrategy.h"
+
+namespace {
+// Run indices owned by one worker. The owner takes from the front and
+// thieves take from the back, so they rarely contend for the same end.
+struct WorkQueue {
+    std::mutex lock;
+    std::deque<size_t> tasks;
+    
+    bool popFront(size_t& task) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (tasks.empty()) {
+            return false;
+        }
+        task = tasks.front();
+        tasks.pop_front();
+        return true;
+    }
+    
+    bool popBack(size_t& task) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (tasks.empty()) {
+            return false;
+        }
+        task = tasks.back();
+        tasks.pop_back();
+        return true;
+    }
+};
+}
+
+void RunMetrics::merge(const RunMetrics& other) {
+    runs += other.runs;
+    passengers += other.passengers;
+    passengersServed += other.passengersServed;
+    eventsProcessed += other.eventsProcessed;
+    floorsTravelled += other.floorsTravelled;
+    stopsServed += other.stopsServed;
+    simulatedSeconds += other.simulatedSeconds;
+    energyKWh += other.energyKWh;
+    regeneratedKWh += other.regeneratedKWh;
+    waitTimes.merge(other.waitTimes);
+    rideTimes.merge(other.rideTimes);
+    runMeanWaits.insert(runMeanWaits.end(), other.runMeanWaits.begin(), other.runMeanWaits.end());
+}
+
+MonteCarloRunner::MonteCarloRunner(int numThreads) : numThreads(numThreads) {
+    if (numThreads < 0) {
+        throw std::invalid_argument("Thread count cannot be negative");
+    }
+    if (this->numThreads == 0) {
+        this->numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+RunMetrics MonteCarloRunner::run(const std::vector<Scenario>& scenarios) const {
+    RunMetrics total;
+    size_t workers = std::min<size_t>(numThreads, scenarios.size());
+    if (workers == 0) {
+        return total;
+    }
+    
+    // Deal contiguous blocks of runs to each worker up front; since runs
+    // never spawn more work, a worker is done once every queue is empty
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    for (size_t w = 0; w < workers; w++) {
+        queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+        size_t first = w * scenarios.size() / workers;
+        size_t last = (w + 1) * scenarios.size() / workers;
+        for (size_t i = first; i < last; i++) {
+            queues[w]->tasks.push_back(i);
+        }
+    }
+    
+    std::vector<RunMetrics> totals(workers);         // Per worker
+    std::vector<double> runMeans(scenarios.size()); // Per run, written by whichever worker ran it
+    std::mutex errorLock;
+    std::exception_ptr firstError;
+    
+    auto worker = [&](size_t self) {
+        std::unique_ptr<Building> building; // Reused across this worker's runs
+        size_t task;
+        while (true) {
+            bool found = queues[self]->popFront(task);
+            for (size_t k = 1; !found && k < workers; k++) {
+                found = queues[(self + k) % workers]->popBack(task);
+            }
+            if (!found) {
+                return;
+            }
+            
+            try {
+                RunMetrics result = runScenario(scenarios[task], building);
+                runMeans[task] = result.waitTimes.mean();
+                result.runMeanWaits.clear();
+                totals[self].merge(result);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(errorLock);
+                if (!firstError) {
+                    firstError = std::current_exception();
+                }
+            }
+        }
+    };
+    
+    std::vector<std::thread> threads;
+    for (size_t w = 1; w < workers; w++) {
+        threads.emplace_back(worker, w);
+    }
+    worker(0); // The calling thread does its share too
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+    for (const auto& worker : totals) {
+        total.merge(worker);
+    }
+    total.runMeanWaits.swap(runMeans);
+    return total;
+}
+
+RunMetrics MonteCarloRunner::runScenario(const Scenario& scenario) {
+    std::unique_ptr<Building> building;
+    return runScenario(scenario, building);
+}
+
+RunMetrics MonteCarloRunner::runScenario(const Scenario& scenario, std::unique_ptr<Building>& building) {
+    std::unique_ptr<DispatchStrategy> strategy = DispatchStrategy::create(scenario.strategy);
+    if (!strategy) {
+        throw std::invalid_argument("Unknown dispatch strategy: " + scenario.strategy);
+    }
+    strategy->setEnergyWeight(scenario.energyWeight);
+    
+    std::unique_ptr<TrafficGenerator> traffic;
+    if (scenario.checkpoint) {
+        // Fork: same state up to now, a different future from here on
+        Checkpoint checkpoint = Checkpoint::fromBytes(*scenario.checkpoint);
+        building = std::move(checkpoint.building);
+        traffic = std::move(checkpoint.traffic);
+        if (traffic) {
+            traffic->reseed(scenario.seed);
+        }
+        building->resetStatistics();
+    } else {
+        if (building && building->getNumFloors() == scenario.numFloors &&
+            building->getNumElevators() == scenario.numElevators) {
+            building->reset();
+            building->setElevatorCapacity(scenario.capacity);
+        } else {
+            building.reset(new Building(scenario.numFloors, scenario.numElevators, scenario.capacity));
+        }
+        for (size_t i = 0; i < building->getElevators().size(); i++) {
+            building->setCarParams(i, i < scenario.carParams.size() ? scenario.carParams[i]
+                                                                    : Elevator::defaultParams());
+        }
+        
+        traffic.reset(new TrafficGenerator(scenario.numFloors, scenario.passengersPerHour, scenario.seed));
+        if (scenario.originDestination.empty()) {
+            traffic->setPattern(scenario.pattern);
+        } else {
+            traffic->setOriginDestinationMatrix(scenario.originDestination);
+        }
+    }
+    building->setDispatchStrategy(std::move(strategy));
+    building->setDestinationDispatch(SimClock::fromSeconds(scenario.batchWindow));
+    
+    RunMetrics metrics;
+    metrics.runs = 1;
+    SimTime start = building->getClock().now();
+    if (traffic) {
+        metrics.passengers = traffic->run(*building, SimClock::fromSeconds(scenario.duration));
+    }
+    while (building->step()) {
+    }
+    
+    metrics.passengersServed = building->getPassengersServed();
+    metrics.eventsProcessed = building->getEventsProcessed();
+    metrics.simulatedSeconds = SimClock::toSeconds(building->getClock().now() - start);
+    for (const auto& elevator : building->getElevators()) {
+        metrics.floorsTravelled += elevator.getFloorsTravelled();
+        metrics.stopsServed += elevator.getStopsServed();
+        metrics.energyKWh += EnergyModel::toKWh(elevator.getNetEnergy());
+        metrics.regeneratedKWh += EnergyModel::toKWh(elevator.getEnergyUse().regenerated);
+    }
+    metrics.waitTimes = building->getWaitTimes();
+    metrics.rideTimes = building->getRideTimes();
+    metrics.runMeanWaits.push_back(metrics.waitTimes.mean());
+    return metrics;
+}
+
+std::vector<Scenario> MonteCarloRunner::seedSweep(const Scenario& base, int runs) {
+    std::vector<Scenario> scenarios(std::max(runs, 0), base);
+    for (size_t i = 0; i < scenarios.size(); i++) {
+        scenarios[i].seed = base.seed + i;
+    }
+    return scenarios;
+}
+
+int MonteCarloRunner::getThreadCount() const {
+    return numThreads;
+}
@@ -0,0 +1,86 @@
+#ifndef MONTECARLORUNNER_H
+#define MONTECARLORUNNER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Building.h"
+#include "LatencyStats.h"
+#include "TrafficGenerator.h"
+
+// One seeded simulation: building size, traffic and dispatch settings
+struct Scenario {
+    int numFloors = 10;
+    int numElevators = 4;
+    int capacity = Building::DEFAULT_ELEVATOR_CAPACITY;
+    TrafficGenerator::Pattern pattern = TrafficGenerator::INTERFLOOR;
+    std::vector<double> originDestination; // Overrides the pattern when not empty
+    double passengersPerHour = 200.0;
+    double duration = 3600.0;              // Seconds over which passengers arrive
+    std::string strategy = "nearest";
+    std::vector<Elevator::Params> carParams; // One per car; empty keeps the defaults
+    double energyWeight = 0.0;             // Seconds of waiting per kWh in dispatch cost
+    double batchWindow = 0.0;              // Destination dispatch batching in seconds; 0 uses hall calls
+    
+    // Saved state to fork from (see Checkpoint). The building size and car
+    // settings then come from the snapshot, its traffic is reseeded with
+    // seed, and metrics cover only the time after the fork.
+    std::shared_ptr<const std::string> checkpoint;
+    std::uint64_t seed = 1;
+};
+
+// Results of one run, or of several runs merged together
+struct RunMetrics {
+    int runs = 0;
+    long passengers = 0;
+    long passengersServed = 0;
+    long eventsProcessed = 0;
+    long floorsTravelled = 0;
+    long stopsServed = 0;
+    double simulatedSeconds = 0.0;
+    double energyKWh = 0.0;                // Net of regeneration
+    double regeneratedKWh = 0.0;
+    LatencyStats waitTimes;
+    LatencyStats rideTimes;
+    std::vector<double> runMeanWaits; // Mean wait of each run, for confidence intervals
+    
+    void merge(const RunMetrics& other); // Appends the other's run means
+};
+
+// Runs many independent Building simulations in parallel. Each run owns
+// its building, clock and random generator, so runs share nothing while
+// they execute. Runs are spread over a fixed set of worker threads; a
+// worker that finishes its share steals queued runs from the others, so
+// long and short scenarios still balance across cores. Each worker merges
+// its runs into its own totals as they finish, so memory does not grow
+// with the number of runs. The run means come back in scenario order;
+// every count, histogram and run mean is independent of the thread count,
+// while pooled means and sums can differ in the last bits of rounding.
+class MonteCarloRunner {
+public:
+    // 0 threads uses every hardware thread
+    explicit MonteCarloRunner(int numThreads = 0);
+    
+    // Every scenario, merged
+    RunMetrics run(const std::vector<Scenario>& scenarios) const;
+    
+    // Simulate one scenario to completion on the calling thread
+    static RunMetrics runScenario(const Scenario& scenario);
+    
+    // The same, reusing building if it has the scenario's size: it is
+    // reset rather than rebuilt, so the memory it grew into is kept.
+    // Otherwise a new building is made and left in building for the next
+    // call.
+    static RunMetrics runScenario(const Scenario& scenario, std::unique_ptr<Building>& building);
+    
+    // The same scenario repeated with seeds base.seed, base.seed + 1, ...
+    static std::vector<Scenario> seedSweep(const Scenario& base, int runs);
+    
+    int getThreadCount() const;
+    
+private:
+    int numThreads;
+};
+
+#endif // MONTECARLORUNNER_H
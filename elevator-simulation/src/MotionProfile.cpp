@@ -0,0 +1,115 @@
+#include "MotionProfile.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+MotionProfile::MotionProfile(double ratedSpeed, double acceleration, double jerk)
+    : ratedSpeed(ratedSpeed), acceleration(acceleration), jerk(jerk) {
+    if (!(ratedSpeed > 0.0) || !(acceleration > 0.0) || !(jerk > 0.0)) {
+        throw std::invalid_argument("Speed, acceleration and jerk must be positive");
+    }
+}
+
+double MotionProfile::travelTime(double distance) const {
+    if (distance <= 0.0) {
+        return 0.0;
+    }
+    Run run = plan(distance);
+    return 2.0 * run.rampTime + run.cruiseTime;
+}
+
+double MotionProfile::distanceAt(double distance, double seconds) const {
+    if (distance <= 0.0 || seconds <= 0.0) {
+        return 0.0;
+    }
+    
+    Run run = plan(distance);
+    double total = 2.0 * run.rampTime + run.cruiseTime;
+    if (seconds >= total) {
+        return distance;
+    }
+    if (seconds <= run.rampTime) {
+        return rampDistanceAt(run, seconds);
+    }
+    if (seconds <= run.rampTime + run.cruiseTime) {
+        return run.rampDistance + run.speed * (seconds - run.rampTime);
+    }
+    
+    // Braking mirrors the start
+    return distance - rampDistanceAt(run, total - seconds);
+}
+
+double MotionProfile::peakSpeed(double distance) const {
+    return (distance > 0.0) ? plan(distance).speed : 0.0;
+}
+
+void MotionProfile::save(BinaryWriter& out) const {
+    out.writeDouble(ratedSpeed);
+    out.writeDouble(acceleration);
+    out.writeDouble(jerk);
+}
+
+MotionProfile MotionProfile::restore(BinaryReader& in) {
+    double speed = in.readDouble();
+    double accel = in.readDouble();
+    return MotionProfile(speed, accel, in.readDouble());
+}
+
+MotionProfile::Run MotionProfile::plan(double distance) const {
+    // Long enough to cruise at rated speed?
+    Run run = ramp(ratedSpeed);
+    if (2.0 * run.rampDistance <= distance) {
+        run.cruiseTime = (distance - 2.0 * run.rampDistance) / ratedSpeed;
+        return run;
+    }
+    
+    // No cruise: the ramp distance, which grows with the peak speed v, must
+    // be half the run. Without reaching full acceleration the ramp covers
+    // v * sqrt(v / jerk); with it, v * (v / acceleration + acceleration / jerk) / 2.
+    double half = distance / 2.0;
+    double speed = std::cbrt(half * half * jerk);
+    if (speed * jerk > acceleration * acceleration) {
+        double lag = acceleration * acceleration / jerk;
+        speed = (-lag + std::sqrt(lag * lag + 4.0 * acceleration * distance)) / 2.0;
+    }
+    run = ramp(std::min(speed, ratedSpeed));
+    run.cruiseTime = 0.0;
+    return run;
+}
+
+MotionProfile::Run MotionProfile::ramp(double speed) const {
+    Run run;
+    run.speed = speed;
+    if (speed * jerk >= acceleration * acceleration) {
+        run.accel = acceleration;
+        run.jerkTime = acceleration / jerk;
+        run.constTime = speed / acceleration - run.jerkTime;
+    } else {
+        run.accel = std::sqrt(speed * jerk);
+        run.jerkTime = run.accel / jerk;
+        run.constTime = 0.0;
+    }
+    run.rampTime = 2.0 * run.jerkTime + run.constTime;
+    
+    // The ramp is point-symmetric about its midpoint, so the car averages
+    // half its peak speed
+    run.rampDistance = speed * run.rampTime / 2.0;
+    run.cruiseTime = 0.0;
+    return run;
+}
+
+double MotionProfile::rampDistanceAt(const Run& run, double seconds) const {
+    double t = std::min(std::max(seconds, 0.0), run.rampTime);
+    if (t <= run.jerkTime) {
+        return jerk * t * t * t / 6.0;
+    }
+    if (t <= run.jerkTime + run.constTime) {
+        double tj = run.jerkTime;
+        double tc = t - tj;
+        return jerk * tj * tj * tj / 6.0 + (jerk * tj * tj / 2.0) * tc + run.accel * tc * tc / 2.0;
+    }
+    
+    // Last jerk phase: the speed deficit to peak mirrors the first phase
+    double left = run.rampTime - t;
+    return run.rampDistance - run.speed * left + jerk * left * left * left / 6.0;
+}
@@ -0,0 +1,59 @@
+#ifndef MOTIONPROFILE_H
+#define MOTIONPROFILE_H
+
+#include "BinaryStream.h"
+
+// Jerk-limited (S-curve) motion of a car from rest to rest. Acceleration
+// ramps up at the jerk limit, holds at the acceleration limit, ramps back
+// down as the car reaches its peak speed, and the stop mirrors the start:
+//
+//   speed
+//     ^     ____________      cruise
+//     |    /            \     brake, with the
+//     |   /              \    same S-curve as
+//     |__/                \__ the start
+//     +-----------------------> time
+//
+// Short runs never reach rated speed and may never reach full
+// acceleration; the peak speed is then solved for so that the ramp up and
+// ramp down exactly cover the distance. Every quantity is closed-form, so
+// the time for any run can be queried without stepping the motion.
+class MotionProfile {
+public:
+    // Rated speed in m/s, acceleration in m/s^2 and jerk in m/s^3
+    MotionProfile(double ratedSpeed, double acceleration, double jerk);
+    
+    // Seconds to cover distance metres, starting and ending at rest
+    double travelTime(double distance) const;
+    
+    // Metres covered after the given seconds of a run of distance metres
+    double distanceAt(double distance, double seconds) const;
+    
+    // Peak speed reached on a run of distance metres
+    double peakSpeed(double distance) const;
+    
+    void save(BinaryWriter& out) const;
+    static MotionProfile restore(BinaryReader& in);
+    
+private:
+    double ratedSpeed;
+    double acceleration;
+    double jerk;
+    
+    // Phase durations of one run
+    struct Run {
+        double speed;      // Peak speed
+        double accel;      // Peak acceleration
+        double jerkTime;   // Each jerk phase
+        double constTime;  // Constant acceleration phase
+        double rampTime;   // Whole ramp from rest to peak speed
+        double rampDistance;
+        double cruiseTime;
+    };
+    
+    Run plan(double distance) const;
+    Run ramp(double speed) const;  // Ramp to the given peak speed, no cruise
+    double rampDistanceAt(const Run& run, double seconds) const;
+};
+
+#endif // MOTIONPROFILE_H
@@ -0,0 +1,23 @@
+#include "NearestCarStrategy.h"
+#include <cstdlib>
+
+const char* NearestCarStrategy::getName() const {
+    return "nearest";
+}
+
+double NearestCarStrategy::cost(const Request& request, const Elevator& elevator,
+                                int numFloors, int /*numElevators*/) const {
+    int floor = elevator.getCurrentFloor();
+    int distance = std::abs(floor - request.getFloor());
+    
+    // If elevator is idle or heading in the same direction as the request, it's preferred
+    if (!elevator.isMoving() ||
+        (elevator.getCurrentDirection() == request.getDirection() &&
+         ((request.getDirection() == Request::UP && floor < request.getFloor()) ||
+          (request.getDirection() == Request::DOWN && floor > request.getFloor())))) {
+        return distance;
+    }
+    
+    // Otherwise rank it behind every preferred car
+    return distance + numFloors + 1;
+}
@@ -0,0 +1,17 @@
+#ifndef NEARESTCARSTRATEGY_H
+#define NEARESTCARSTRATEGY_H
+
+#include "DispatchStrategy.h"
+
+// Closest car that is idle or already heading towards the call in the
+// call's direction; otherwise simply the closest car
+class NearestCarStrategy : public DispatchStrategy {
+public:
+    const char* getName() const override;
+    
+protected:
+    double cost(const Request& request, const Elevator& elevator,
+                int numFloors, int numElevators) const override;
+};
+
+#endif // NEARESTCARSTRATEGY_H
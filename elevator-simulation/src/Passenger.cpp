@@ -0,0 +1,94 @@
+#include "Passenger.h"
+
+Passenger::Passenger(int id, int origin, int destination, SimTime spawnTime, int journey)
+    : id(id), origin(origin), destination(destination), journey(journey), assignedCar(-1), spawnTime(spawnTime),
+      boardingTime(-1), alightingTime(-1) {
+}
+
+void Passenger::board(SimTime time) {
+    boardingTime = time;
+}
+
+void Passenger::alight(SimTime time) {
+    alightingTime = time;
+}
+
+void Passenger::assignCar(int car) {
+    assignedCar = car;
+}
+
+int Passenger::getAssignedCar() const {
+    return assignedCar;
+}
+
+int Passenger::getId() const {
+    return id;
+}
+
+int Passenger::getOrigin() const {
+    return origin;
+}
+
+int Passenger::getDestination() const {
+    return destination;
+}
+
+int Passenger::getJourney() const {
+    return journey;
+}
+
+Request::Direction Passenger::getDirection() const {
+    return (destination > origin) ? Request::UP : Request::DOWN;
+}
+
+SimTime Passenger::getSpawnTime() const {
+    return spawnTime;
+}
+
+SimTime Passenger::getBoardingTime() const {
+    return boardingTime;
+}
+
+SimTime Passenger::getAlightingTime() const {
+    return alightingTime;
+}
+
+bool Passenger::hasBoarded() const {
+    return boardingTime >= 0;
+}
+
+bool Passenger::hasAlighted() const {
+    return alightingTime >= 0;
+}
+
+SimTime Passenger::getWaitTime() const {
+    return boardingTime - spawnTime;
+}
+
+SimTime Passenger::getRideTime() const {
+    return alightingTime - boardingTime;
+}
+
+void Passenger::save(BinaryWriter& out) const {
+    out.writeInt(id);
+    out.writeInt(origin);
+    out.writeInt(destination);
+    out.writeInt(journey);
+    out.writeInt(assignedCar);
+    out.writeInt64(spawnTime);
+    out.writeInt64(boardingTime);
+    out.writeInt64(alightingTime);
+}
+
+Passenger Passenger::restore(BinaryReader& in) {
+    int id = in.readInt();
+    int origin = in.readInt();
+    int destination = in.readInt();
+    int journey = in.readInt();
+    int assignedCar = in.readInt();
+    Passenger passenger(id, origin, destination, in.readInt64(), journey);
+    passenger.assignedCar = assignedCar;
+    passenger.boardingTime = in.readInt64();
+    passenger.alightingTime = in.readInt64();
+    return passenger;
+}
@@ -0,0 +1,50 @@
+#ifndef PASSENGER_H
+#define PASSENGER_H
+
+#include "BinaryStream.h"
+#include "Request.h"
+#include "SimClock.h"
+
+// A single trip from an origin floor to a destination floor. On a campus
+// the trip may be one leg of a longer journey through several banks.
+class Passenger {
+public:
+    Passenger(int id, int origin, int destination, SimTime spawnTime, int journey = -1);
+    
+    void board(SimTime time);
+    void alight(SimTime time);
+    
+    // Car a destination dispatcher told the passenger to take, -1 for none
+    void assignCar(int car);
+    int getAssignedCar() const;
+    
+    int getId() const;
+    int getOrigin() const;
+    int getDestination() const;
+    int getJourney() const; // -1 unless the trip is a leg of a campus journey
+    Request::Direction getDirection() const;
+    SimTime getSpawnTime() const;
+    SimTime getBoardingTime() const;
+    SimTime getAlightingTime() const;
+    bool hasBoarded() const;
+    bool hasAlighted() const;
+    
+    // Latencies, only meaningful once the passenger has boarded/alighted
+    SimTime getWaitTime() const;
+    SimTime getRideTime() const;
+    
+    void save(BinaryWriter& out) const;
+    static Passenger restore(BinaryReader& in);
+    
+private:
+    int id;
+    int origin;
+    int destination;
+    int journey;
+    int assignedCar;
+    SimTime spawnTime;
+    SimTime boardingTime;   // -1 until boarded
+    SimTime alightingTime;  // -1 until alighted
+};
+
+#endif // PASSENGER_H
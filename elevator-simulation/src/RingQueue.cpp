@@ -0,0 +1,100 @@
+#include "RingQueue.h"
+#include <utility>
+
+namespace {
+const int INITIAL_SIZE_CLASS = 3; // Eight passengers
+}
+
+RingQueue::RingQueue(BlockPool& pool)
+    : pool(&pool), ring(nullptr), sizeClass(0), mask(0), head(0), count(0) {
+}
+
+RingQueue::~RingQueue() {
+    if (ring) {
+        pool->release(ring, sizeClass);
+    }
+}
+
+RingQueue::RingQueue(RingQueue&& other) noexcept
+    : pool(other.pool), ring(other.ring), sizeClass(other.sizeClass), mask(other.mask),
+      head(other.head), count(other.count) {
+    other.ring = nullptr;
+    other.count = 0;
+}
+
+RingQueue& RingQueue::operator=(RingQueue&& other) noexcept {
+    if (this != &other) {
+        if (ring) {
+            pool->release(ring, sizeClass);
+        }
+        pool = other.pool;
+        ring = std::exchange(other.ring, nullptr);
+        sizeClass = other.sizeClass;
+        mask = other.mask;
+        head = other.head;
+        count = std::exchange(other.count, 0);
+    }
+    return *this;
+}
+
+void RingQueue::push(int value) {
+    if (!ring || count > mask) {
+        grow();
+    }
+    ring[(head + count) & mask] = value;
+    count++;
+}
+
+void RingQueue::pop() {
+    if (count > 0) {
+        head++;
+        count--;
+    }
+}
+
+int RingQueue::front() const {
+    return ring[head & mask];
+}
+
+int RingQueue::operator[](size_t index) const {
+    return ring[(head + index) & mask];
+}
+
+int& RingQueue::operator[](size_t index) {
+    return ring[(head + index) & mask];
+}
+
+void RingQueue::truncate(size_t newCount) {
+    if (newCount < count) {
+        count = newCount;
+    }
+}
+
+void RingQueue::clear() {
+    head = 0;
+    count = 0;
+}
+
+size_t RingQueue::size() const {
+    return count;
+}
+
+bool RingQueue::empty() const {
+    return count == 0;
+}
+
+void RingQueue::grow() {
+    int newClass = ring ? sizeClass + 1 : INITIAL_SIZE_CLASS;
+    int* newRing = pool->acquire(newClass);
+    for (size_t i = 0; i < count; i++) {
+        newRing[i] = (*this)[i];
+    }
+    if (ring) {
+        pool->release(ring, sizeClass);
+    }
+    
+    ring = newRing;
+    sizeClass = newClass;
+    mask = (size_t(1) << newClass) - 1;
+    head = 0;
+}
@@ -0,0 +1,45 @@
+#ifndef RINGQUEUE_H
+#define RINGQUEUE_H
+
+#include <cstddef>
+#include "BlockPool.h"
+
+// FIFO of ints in a power-of-two ring whose block comes from a BlockPool.
+// A full ring moves into a block twice the size and returns the old one
+// to the pool. Element i counts from the front.
+class RingQueue {
+public:
+    explicit RingQueue(BlockPool& pool);
+    ~RingQueue();
+    
+    RingQueue(RingQueue&& other) noexcept;
+    RingQueue& operator=(RingQueue&& other) noexcept;
+    RingQueue(const RingQueue&) = delete;
+    RingQueue& operator=(const RingQueue&) = delete;
+    
+    void push(int value);
+    void pop();
+    int front() const;
+    
+    int operator[](size_t index) const;
+    int& operator[](size_t index);
+    
+    // Keep only the first count elements
+    void truncate(size_t count);
+    void clear();
+    
+    size_t size() const;
+    bool empty() const;
+    
+private:
+    BlockPool* pool;
+    int* ring;      // Null until the first push
+    int sizeClass;  // The ring holds 2^sizeClass ints
+    size_t mask;
+    size_t head;    // Index of the front element, before masking
+    size_t count;
+    
+    void grow();
+};
+
+#endif // RINGQUEUE_H
@@ -0,0 +1,46 @@
+#include "SimClock.h"
+#include <cmath>
+
+SimClock::SimClock() : currentTime(0) {
+}
+
+void SimClock::advance(double seconds) {
+    // Negative steps would let timers run backwards, so ignore them
+    if (seconds > 0.0) {
+        currentTime += fromSeconds(seconds);
+    }
+}
+
+void SimClock::advanceTo(SimTime time) {
+    if (time > currentTime) {
+        currentTime = time;
+    }
+}
+
+void SimClock::reset() {
+    currentTime = 0;
+}
+
+SimTime SimClock::now() const {
+    return currentTime;
+}
+
+double SimClock::nowSeconds() const {
+    return toSeconds(currentTime);
+}
+
+void SimClock::save(BinaryWriter& out) const {
+    out.writeInt64(currentTime);
+}
+
+void SimClock::restore(BinaryReader& in) {
+    currentTime = in.readInt64();
+}
+
+SimTime SimClock::fromSeconds(double seconds) {
+    return static_cast<SimTime>(std::llround(seconds * 1000000.0));
+}
+
+double SimClock::toSeconds(SimTime time) {
+    return static_cast<double>(time) / 1000000.0;
+}
@@ -0,0 +1,33 @@
+#ifndef SIMCLOCK_H
+#define SIMCLOCK_H
+
+#include <cstdint>
+#include "BinaryStream.h"
+
+// Simulated time in integer microseconds. Using integer ticks instead of
+// floating point seconds keeps runs bit-identical for the same input trace.
+using SimTime = std::int64_t;
+
+class SimClock {
+public:
+    SimClock();
+    
+    void advance(double seconds);
+    void advanceTo(SimTime time);
+    void reset();
+    
+    SimTime now() const;
+    double nowSeconds() const;
+    
+    // Checkpointing
+    void save(BinaryWriter& out) const;
+    void restore(BinaryReader& in);
+    
+    static SimTime fromSeconds(double seconds);
+    static double toSeconds(SimTime time);
+    
+private:
+    SimTime currentTime;
+};
+
+#endif // SIMCLOCK_H
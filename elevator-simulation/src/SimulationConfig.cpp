@@ -0,0 +1,207 @@
+#include "SimulationConfig.h"
+#include <cctype>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "DispatchStrategy.h"
+
+namespace {
+std::string trim(const std::string& text) {
+    size_t first = 0;
+    size_t last = text.size();
+    while (first < last && std::isspace(static_cast<unsigned char>(text[first]))) {
+        first++;
+    }
+    while (last > first && std::isspace(static_cast<unsigned char>(text[last - 1]))) {
+        last--;
+    }
+    return text.substr(first, last - first);
+}
+
+int parseInt(const std::string& value, int low, int high) {
+    size_t used = 0;
+    long result = 0;
+    try {
+        result = std::stol(value, &used);
+    }
+    catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != value.size()) {
+        throw std::invalid_argument("expected an integer");
+    }
+    if (result < low || result > high) {
+        throw std::out_of_range("must be between " + std::to_string(low) + " and " + std::to_string(high));
+    }
+    return result;
+}
+
+double parseDouble(const std::string& value, double low, double high) {
+    size_t used = 0;
+    double result = 0.0;
+    try {
+        result = std::stod(value, &used);
+    }
+    catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != value.size()) {
+        throw std::invalid_argument("expected a number");
+    }
+    if (!(result >= low && result <= high)) {
+        throw std::out_of_range("must be between " + std::to_string(low) + " and " + std::to_string(high));
+    }
+    return result;
+}
+
+bool parseBool(const std::string& value) {
+    if (value == "true" || value == "1" || value == "yes" || value == "on") {
+        return true;
+    }
+    if (value == "false" || value == "0" || value == "no" || value == "off") {
+        return false;
+    }
+    throw std::invalid_argument("expected true or false");
+}
+
+// Car settings; returns false if the key is not one of them
+bool setCarValue(Elevator::Params& params, const std::string& key, const std::string& value) {
+    if (key == "elevator_speed") {
+        params.ratedSpeed = parseDouble(value, 0.1, 20.0);
+    } else if (key == "elevator_acceleration") {
+        params.acceleration = parseDouble(value, 0.1, 5.0);
+    } else if (key == "elevator_jerk") {
+        params.jerk = parseDouble(value, 0.1, 10.0);
+    } else if (key == "door_operation_time") {
+        params.doorOperationTime = SimClock::fromSeconds(parseDouble(value, 0.1, 30.0));
+    } else if (key == "door_dwell_time") {
+        params.doorDwellTime = SimClock::fromSeconds(parseDouble(value, 0.0, 300.0));
+    } else if (key == "car_mass") {
+        params.energy.carMass = parseDouble(value, 100.0, 20000.0);
+    } else if (key == "counterweight_balance") {
+        params.energy.counterweightBalance = parseDouble(value, 0.0, 1.0);
+    } else if (key == "drive_efficiency") {
+        params.energy.driveEfficiency = parseDouble(value, 0.1, 1.0);
+    } else if (key == "regen_efficiency") {
+        params.energy.regenEfficiency = parseDouble(value, 0.0, 1.0);
+    } else if (key == "standby_power") {
+        params.energy.standbyPower = parseDouble(value, 0.0, 10000.0);
+    } else if (key == "door_power") {
+        params.energy.doorPower = parseDouble(value, 0.0, 10000.0);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// One car override line, kept until the whole file is read so that the
+// shared car settings may come before or after it
+struct CarOverride {
+    int line;
+    int car;
+    std::string key;
+    std::string value;
+};
+}
+
+SimulationConfig SimulationConfig::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open config file: " + path);
+    }
+    
+    SimulationConfig config;
+    std::vector<CarOverride> overrides;
+    std::string line;
+    int lineNumber = 0;
+    
+    while (std::getline(in, line)) {
+        lineNumber++;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        
+        auto fail = [&](const std::string& message) {
+            return std::runtime_error(path + ":" + std::to_string(lineNumber) + ": " + message);
+        };
+        
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            throw fail("expected key=value");
+        }
+        std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+            value = value.substr(1, value.size() - 2);
+        }
+        
+        try {
+            if (key == "num_floors") {
+                config.numFloors = parseInt(value, Building::MIN_FLOORS, Building::MAX_FLOORS);
+            } else if (key == "num_elevators") {
+                config.numElevators = parseInt(value, Building::MIN_ELEVATORS, Building::MAX_ELEVATORS);
+            } else if (key == "simulation_speed") {
+                // Simulated milliseconds per wall-clock second
+                config.simulationSpeed = parseDouble(value, 1.0, 1000000.0) / 1000.0;
+            } else if (key == "sound_enabled") {
+                config.soundEnabled = parseBool(value);
+            } else if (key == "floor_height") {
+                // Shared by every shaft, so not a per-car setting
+                config.car.floorHeight = parseDouble(value, 2.0, 10.0);
+            } else if (key == "elevator_capacity") {
+                config.elevatorCapacity = parseInt(value, 1, 1000);
+            } else if (key == "request_handling_strategy") {
+                if (!DispatchStrategy::create(value)) {
+                    throw std::invalid_argument(std::string("unknown strategy; expected one of ") +
+                                                DispatchStrategy::getAvailableNames());
+                }
+                config.strategy = value;
+            } else if (key.compare(0, 4, "car.") == 0) {
+                size_t dot = key.find('.', 4);
+                if (dot == std::string::npos) {
+                    throw std::invalid_argument("expected car.<n>.<setting>");
+                }
+                int car = parseInt(key.substr(4, dot - 4), 1, Building::MAX_ELEVATORS);
+                std::string setting = key.substr(dot + 1);
+                
+                // Check the value now so the error points at this line
+                Elevator::Params scratch = config.car;
+                if (!setCarValue(scratch, setting, value)) {
+                    throw std::invalid_argument("unknown car setting '" + setting + "'");
+                }
+                overrides.push_back({lineNumber, car - 1, setting, value});
+            } else if (!setCarValue(config.car, key, value)) {
+                throw std::invalid_argument("unknown key");
+            }
+        }
+        catch (const std::exception& e) {
+            throw fail("'" + key + "': " + e.what());
+        }
+    }
+    
+    for (const auto& entry : overrides) {
+        if (entry.car >= config.numElevators) {
+            throw std::runtime_error(path + ":" + std::to_string(entry.line) + ": car " +
+                                     std::to_string(entry.car + 1) + " does not exist");
+        }
+        auto inserted = config.carOverrides.insert(std::make_pair(entry.car, config.car));
+        setCarValue(inserted.first->second, entry.key, entry.value);
+    }
+    
+    return config;
+}
+
+Elevator::Params SimulationConfig::carParams(int elevatorIndex) const {
+    auto it = carOverrides.find(elevatorIndex);
+    return (it != carOverrides.end()) ? it->second : car;
+}
+
+void SimulationConfig::applyTo(Building& building) const {
+    building.setElevatorCapacity(elevatorCapacity);
+    for (int i = 0; i < building.getNumElevators(); i++) {
+        building.setCarParams(i, carParams(i));
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef SIMULATIONCONFIG_H
+#define SIMULATIONCONFIG_H
+
+#include <map>
+#include <string>
+#include "Building.h"
+#include "Elevator.h"
+
+// Settings read from a key=value file such as assets/config.txt. Blank
+// lines and lines starting with '#' are ignored. Car settings apply to
+// every car unless overridden for one car with a "car.<n>." prefix, where
+// n counts from 1:
+//
+//   door_dwell_time=1.5
+//   car.2.door_dwell_time=4.0
+//
+// Unknown keys and out-of-range values are errors, so a typo never goes
+// unnoticed.
+struct SimulationConfig {
+    int numFloors = 10;
+    int numElevators = 4;
+    double simulationSpeed = 1.0; // Simulated seconds per wall-clock second
+    bool soundEnabled = true;
+    int elevatorCapacity = Building::DEFAULT_ELEVATOR_CAPACITY;
+    std::string strategy = "nearest";
+    Elevator::Params car = Elevator::defaultParams();
+    std::map<int, Elevator::Params> carOverrides; // By car index from 0
+    
+    // Throws std::runtime_error naming the file and line of the first bad entry
+    static SimulationConfig load(const std::string& path);
+    
+    // Settings for one car, with any override applied
+    Elevator::Params carParams(int elevatorIndex) const;
+    
+    // Push capacity and car settings into a building of this size
+    void applyTo(Building& building) const;
+};
+
+#endif // SIMULATIONCONFIG_H
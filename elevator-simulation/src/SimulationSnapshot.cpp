@@ -0,0 +1,24 @@
+#include "SimulationSnapshot.h"
+
+SnapshotBuffer::SnapshotBuffer(int numElevators) : middle(1), backIndex(0), frontIndex(2) {
+    // Size every slot up front so that publishing never allocates
+    for (auto& slot : slots) {
+        slot.cars.resize(numElevators, CarSnapshot{1, 1.0f, false, false});
+    }
+}
+
+SimulationSnapshot& SnapshotBuffer::back() {
+    return slots[backIndex];
+}
+
+void SnapshotBuffer::publish() {
+    // Release makes the filled slot visible to the reader that acquires it
+    backIndex = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel) & ~FRESH;
+}
+
+const SimulationSnapshot& SnapshotBuffer::latest() {
+    if (middle.load(std::memory_order_relaxed) & FRESH) {
+        frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & ~FRESH;
+    }
+    return slots[frontIndex];
+}
@@ -0,0 +1,50 @@
+#ifndef SIMULATIONSNAPSHOT_H
+#define SIMULATIONSNAPSHOT_H
+
+#include <atomic>
+#include <vector>
+#include "SimClock.h"
+
+// What the view needs to draw one frame, copied out of the model at the
+// end of a simulation tick
+struct CarSnapshot {
+    int floor;      // Nearest floor while moving
+    float position; // Fractional floor, for smooth animation
+    bool moving;
+    bool doorsOpen;
+};
+
+struct SimulationSnapshot {
+    SimTime time = 0;
+    int numFloors = 0;
+    int passengersServed = 0;
+    std::vector<CarSnapshot> cars;
+};
+
+// Lock-free triple buffer between one writer (the simulation thread) and
+// one reader (the render thread). The writer fills the back slot and swaps
+// it with the middle one; the reader swaps the middle slot into the front
+// whenever a newer snapshot is there. Neither side ever waits, and the
+// reader always sees a complete snapshot.
+class SnapshotBuffer {
+public:
+    explicit SnapshotBuffer(int numElevators);
+    
+    // Writer side
+    SimulationSnapshot& back();
+    void publish();
+    
+    // Reader side: the most recently published snapshot, valid until the
+    // next call
+    const SimulationSnapshot& latest();
+    
+private:
+    static const int FRESH = 4; // Set in middle when the writer has published since the last read
+    
+    SimulationSnapshot slots[3];
+    std::atomic<int> middle;
+    int backIndex;
+    int frontIndex;
+};
+
+#endif // SIMULATIONSNAPSHOT_H
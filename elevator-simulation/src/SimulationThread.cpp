@@ -0,0 +1,223 @@
+#include "SimulationThread.h"
+#include <chrono>
+#include <stdexcept>
+#include <system_error>
+#include "DispatchStrategy.h"
+
+const double SimulationThread::TICK_SECONDS = 1.0 / 120.0;
+
+namespace {
+// After a stall longer than this the thread drops the missed ticks instead
+// of running them back to back
+const std::chrono::milliseconds MAX_LAG(250);
+
+// Look at the config file twice a second
+const int CONFIG_CHECK_TICKS = 60;
+
+bool sameEnergy(const EnergyModel::Params& a, const EnergyModel::Params& b) {
+    return a.carMass == b.carMass && a.passengerMass == b.passengerMass &&
+           a.counterweightBalance == b.counterweightBalance && a.driveEfficiency == b.driveEfficiency &&
+           a.regenEfficiency == b.regenEfficiency && a.standbyPower == b.standbyPower && a.doorPower == b.doorPower;
+}
+
+bool sameParams(const Elevator::Params& a, const Elevator::Params& b) {
+    return a.ratedSpeed == b.ratedSpeed && a.acceleration == b.acceleration && a.jerk == b.jerk &&
+           a.floorHeight == b.floorHeight && a.doorOperationTime == b.doorOperationTime && a.doorDwellTime == b.doorDwellTime &&
+           sameEnergy(a.energy, b.energy);
+}
+}
+
+SimulationThread::SimulationThread(Building& building, double speed)
+    : building(building), speed(speed), running(false), soundEnabled(true),
+      snapshots(building.getNumElevators()), ticksUntilConfigCheck(0), configStatusFailed(false),
+      configStatusReady(false), pendingStatusFailed(false) {
+    // The view can draw the initial state before the first tick
+    publishSnapshot();
+}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+void SimulationThread::start() {
+    if (running.exchange(true)) {
+        return;
+    }
+    worker = std::thread(&SimulationThread::run, this);
+}
+
+void SimulationThread::stop() {
+    running = false;
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+bool SimulationThread::post(const SimCommand& command) {
+    return commands.push(command);
+}
+
+const SimulationSnapshot& SimulationThread::latestSnapshot() {
+    return snapshots.latest();
+}
+
+void SimulationThread::setSpeed(double newSpeed) {
+    speed = (newSpeed > 0.0) ? newSpeed : 0.0;
+}
+
+double SimulationThread::getSpeed() const {
+    return speed;
+}
+
+bool SimulationThread::isSoundEnabled() const {
+    return soundEnabled;
+}
+
+void SimulationThread::watchConfig(const std::string& path, const SimulationConfig& current) {
+    if (running) {
+        throw std::logic_error("Config watching must be set up before the simulation starts");
+    }
+    
+    configPath = path;
+    config = current;
+    soundEnabled = current.soundEnabled;
+    
+    // Anything already in the file is part of the current setup
+    std::error_code error;
+    configTime = std::filesystem::last_write_time(path, error);
+    ticksUntilConfigCheck = CONFIG_CHECK_TICKS;
+}
+
+bool SimulationThread::takeConfigStatus(std::string& message, bool& failed) {
+    if (!configStatusReady.load(std::memory_order_acquire)) {
+        return false;
+    }
+    message = configStatus;
+    failed = configStatusFailed;
+    configStatusReady.store(false, std::memory_order_release);
+    return true;
+}
+
+void SimulationThread::run() {
+    const auto tick = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(TICK_SECONDS));
+    auto nextTick = std::chrono::steady_clock::now();
+    
+    while (running) {
+        if (!configPath.empty() && --ticksUntilConfigCheck <= 0) {
+            checkConfig();
+            publishConfigStatus();
+        }
+        applyCommands();
+        building.update(TICK_SECONDS * speed);
+        publishSnapshot();
+        
+        nextTick += tick;
+        auto now = std::chrono::steady_clock::now();
+        if (now - nextTick > MAX_LAG) {
+            nextTick = now;
+        }
+        std::this_thread::sleep_until(nextTick);
+    }
+}
+
+void SimulationThread::applyCommands() {
+    SimCommand command;
+    while (commands.pop(command)) {
+        switch (command.type) {
+            case SimCommand::HALL_CALL:
+                building.addRequest(Request(command.floor, command.direction));
+                break;
+            case SimCommand::CAR_CALL:
+                building.addCarCall(command.elevator, command.floor);
+                break;
+            case SimCommand::OPEN_DOORS:
+                building.openCarDoors(command.elevator);
+                break;
+        }
+    }
+}
+
+void SimulationThread::publishSnapshot() {
+    SimulationSnapshot& snapshot = snapshots.back();
+    snapshot.time = building.getClock().now();
+    snapshot.numFloors = building.getNumFloors();
+    snapshot.passengersServed = building.getPassengersServed();
+    
+    const auto& elevators = building.getElevators();
+    for (size_t i = 0; i < elevators.size(); i++) {
+        snapshot.cars[i].floor = elevators[i].getCurrentFloor();
+        snapshot.cars[i].position = elevators[i].getPosition();
+        snapshot.cars[i].moving = elevators[i].isMoving();
+        snapshot.cars[i].doorsOpen = elevators[i].doorsOpen();
+    }
+    snapshots.publish();
+}
+
+void SimulationThread::checkConfig() {
+    ticksUntilConfigCheck = CONFIG_CHECK_TICKS;
+    
+    std::error_code error;
+    auto modified = std::filesystem::last_write_time(configPath, error);
+    if (error || modified == configTime) {
+        return;
+    }
+    configTime = modified;
+    
+    // A file that fails validation leaves the running settings untouched
+    SimulationConfig next;
+    try {
+        next = SimulationConfig::load(configPath);
+    }
+    catch (const std::exception& e) {
+        reportConfig(std::string("Config not reloaded: ") + e.what(), true);
+        return;
+    }
+    applyConfigChanges(next);
+}
+
+void SimulationThread::applyConfigChanges(const SimulationConfig& next) {
+    if (next.numFloors != config.numFloors || next.numElevators != config.numElevators) {
+        reportConfig("Config: num_floors and num_elevators only take effect after a restart", false);
+    }
+    if (next.simulationSpeed != config.simulationSpeed) {
+        setSpeed(next.simulationSpeed);
+    }
+    if (next.soundEnabled != config.soundEnabled) {
+        soundEnabled = next.soundEnabled;
+    }
+    if (next.elevatorCapacity != config.elevatorCapacity) {
+        building.setElevatorCapacity(next.elevatorCapacity);
+    }
+    if (next.strategy != config.strategy) {
+        building.setDispatchStrategy(DispatchStrategy::create(next.strategy));
+    }
+    for (int i = 0; i < building.getNumElevators(); i++) {
+        Elevator::Params params = next.carParams(i);
+        if (!sameParams(params, config.carParams(i))) {
+            building.setCarParams(i, params);
+        }
+    }
+    
+    config = next;
+    reportConfig("Reloaded config from " + configPath, false);
+}
+
+void SimulationThread::reportConfig(const std::string& line, bool failed) {
+    if (!pendingStatus.empty()) {
+        pendingStatus += '\n';
+    }
+    pendingStatus += line;
+    pendingStatusFailed = pendingStatusFailed || failed;
+}
+
+void SimulationThread::publishConfigStatus() {
+    if (pendingStatus.empty() || configStatusReady.load(std::memory_order_acquire)) {
+        return;
+    }
+    configStatus.swap(pendingStatus);
+    configStatusFailed = pendingStatusFailed;
+    pendingStatus.clear();
+    pendingStatusFailed = false;
+    configStatusReady.store(true, std::memory_order_release);
+}
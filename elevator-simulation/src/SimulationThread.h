@@ -0,0 +1,89 @@
+#ifndef SIMULATIONTHREAD_H
+#define SIMULATIONTHREAD_H
+
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include "Building.h"
+#include "CommandQueue.h"
+#include "SimulationConfig.h"
+#include "SimulationSnapshot.h"
+
+// Steps a building on its own thread in fixed ticks, independent of the
+// frame rate. Each tick advances simulated time by TICK_SECONDS times the
+// speed multiplier, applies queued user commands first and publishes a
+// snapshot afterwards. The render thread reads snapshots and posts commands
+// without ever taking a lock, and must not touch the building itself while
+// the thread runs.
+//
+// If a config file is being watched, the thread checks it between ticks
+// and applies any setting that changed, so a reload never lands in the
+// middle of an event. The thread never writes to the console; the render
+// thread collects the outcome of each reload with takeConfigStatus.
+class SimulationThread {
+public:
+    static const double TICK_SECONDS; // Wall-clock length of one tick
+    
+    explicit SimulationThread(Building& building, double speed = 1.0);
+    ~SimulationThread();
+    
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+    
+    void start();
+    void stop();
+    
+    // Render thread side
+    bool post(const SimCommand& command); // False if the queue is full
+    const SimulationSnapshot& latestSnapshot();
+    
+    void setSpeed(double speed);
+    double getSpeed() const;
+    bool isSoundEnabled() const;
+    
+    // Reload the file whenever it changes. current is what the file held
+    // when the building was set up; only settings that differ from it are
+    // applied, so command-line overrides survive unrelated edits.
+    void watchConfig(const std::string& path, const SimulationConfig& current);
+    
+    // Render thread side: what the reloads since the last call did, one
+    // line each; false if nothing was reloaded. failed is set if any
+    // reload was rejected.
+    bool takeConfigStatus(std::string& message, bool& failed);
+    
+private:
+    Building& building;
+    std::atomic<double> speed;
+    std::atomic<bool> running;
+    std::atomic<bool> soundEnabled;
+    std::thread worker;
+    CommandQueue commands;
+    SnapshotBuffer snapshots;
+    
+    // Config hot reload, touched only by the worker once it is running
+    std::string configPath;
+    SimulationConfig config;
+    std::filesystem::file_time_type configTime;
+    int ticksUntilConfigCheck;
+    
+    // Reload status passes to the render thread through one slot, filled
+    // by the worker only while configStatusReady is false and emptied by
+    // the render thread before clearing it. Lines reported while the slot
+    // is full wait in pendingStatus.
+    std::string configStatus;
+    bool configStatusFailed;
+    std::atomic<bool> configStatusReady;
+    std::string pendingStatus;
+    bool pendingStatusFailed;
+    
+    void run();
+    void applyCommands();
+    void publishSnapshot();
+    void checkConfig();
+    void applyConfigChanges(const SimulationConfig& next);
+    void reportConfig(const std::string& line, bool failed);
+    void publishConfigStatus();
+};
+
+#endif // SIMULATIONTHREAD_H
@@ -0,0 +1,125 @@
+#include "StopSet.h"
+#include <algorithm>
+
+StopSet::StopSet(std::uint64_t* words, int* count, int numFloors)
+    : words(words), count(count), numFloors(numFloors), numWords(wordsFor(numFloors)) {
+}
+
+int StopSet::wordsFor(int numFloors) {
+    return std::max(numFloors, 0) / 64 + 1;
+}
+
+bool StopSet::insert(int floor) {
+    if (floor < 1 || floor > numFloors) {
+        return false;
+    }
+    
+    std::uint64_t bit = std::uint64_t(1) << (floor & 63);
+    std::uint64_t& word = words[floor >> 6];
+    if (word & bit) {
+        return false;
+    }
+    word |= bit;
+    (*count)++;
+    return true;
+}
+
+bool StopSet::erase(int floor) {
+    if (!contains(floor)) {
+        return false;
+    }
+    
+    words[floor >> 6] &= ~(std::uint64_t(1) << (floor & 63));
+    (*count)--;
+    return true;
+}
+
+bool StopSet::contains(int floor) const {
+    if (floor < 1 || floor > numFloors) {
+        return false;
+    }
+    return (words[floor >> 6] >> (floor & 63)) & 1;
+}
+
+void StopSet::clear() {
+    std::fill(words, words + numWords, 0);
+    *count = 0;
+}
+
+int StopSet::size() const {
+    return *count;
+}
+
+bool StopSet::empty() const {
+    return *count == 0;
+}
+
+int StopSet::lowest() const {
+    return nextAtOrAbove(1);
+}
+
+int StopSet::highest() const {
+    return nextAtOrBelow(numFloors);
+}
+
+int StopSet::nextAtOrAbove(int floor) const {
+    if (*count == 0 || floor > numFloors) {
+        return 0;
+    }
+    floor = std::max(floor, 1);
+    
+    size_t index = floor >> 6;
+    std::uint64_t bits = words[index] & (~std::uint64_t(0) << (floor & 63));
+    while (true) {
+        if (bits) {
+            return static_cast<int>(index * 64 + __builtin_ctzll(bits));
+        }
+        if (++index >= static_cast<size_t>(numWords)) {
+            return 0;
+        }
+        bits = words[index];
+    }
+}
+
+int StopSet::nextAtOrBelow(int floor) const {
+    if (*count == 0 || floor < 1) {
+        return 0;
+    }
+    floor = std::min(floor, numFloors);
+    
+    size_t index = floor >> 6;
+    std::uint64_t bits = words[index] & (~std::uint64_t(0) >> (63 - (floor & 63)));
+    while (true) {
+        if (bits) {
+            return static_cast<int>(index * 64 + 63 - __builtin_clzll(bits));
+        }
+        if (index == 0) {
+            return 0;
+        }
+        bits = words[--index];
+    }
+}
+
+int StopSet::countBetween(int lowFloor, int highFloor) const {
+    lowFloor = std::max(lowFloor, 1);
+    highFloor = std::min(highFloor, numFloors);
+    if (*count == 0 || lowFloor > highFloor) {
+        return 0;
+    }
+    
+    size_t first = lowFloor >> 6;
+    size_t last = highFloor >> 6;
+    std::uint64_t lowMask = ~std::uint64_t(0) << (lowFloor & 63);
+    std::uint64_t highMask = ~std::uint64_t(0) >> (63 - (highFloor & 63));
+    
+    if (first == last) {
+        return __builtin_popcountll(words[first] & lowMask & highMask);
+    }
+    
+    int total = __builtin_popcountll(words[first] & lowMask);
+    for (size_t i = first + 1; i < last; i++) {
+        total += __builtin_popcountll(words[i]);
+    }
+    total += __builtin_popcountll(words[last] & highMask);
+    return total;
+}
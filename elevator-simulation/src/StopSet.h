@@ -0,0 +1,39 @@
+#ifndef STOPSET_H
+#define STOPSET_H
+
+#include <cstdint>
+
+// Set of floors a car has to stop at, stored as a bitset indexed by floor.
+// Insert, erase and lookup are O(1); next-stop and range queries scan one
+// 64-bit word per 64 floors. A StopSet is a view: the words and the count
+// live in the fleet's arrays (see FleetState) and must outlive it.
+class StopSet {
+public:
+    StopSet(std::uint64_t* words, int* count, int numFloors);
+    
+    // Words needed to hold floors 1..numFloors
+    static int wordsFor(int numFloors);
+    
+    bool insert(int floor);     // Returns false if the floor was already queued
+    bool erase(int floor);      // Returns false if the floor was not queued
+    bool contains(int floor) const;
+    void clear();
+    
+    int size() const;
+    bool empty() const;
+    
+    // All queries return 0 when there is no matching stop
+    int lowest() const;
+    int highest() const;
+    int nextAtOrAbove(int floor) const;
+    int nextAtOrBelow(int floor) const;
+    int countBetween(int lowFloor, int highFloor) const; // Inclusive range
+    
+private:
+    std::uint64_t* words; // Bit n is floor n; bit 0 is unused
+    int* count;
+    int numFloors;
+    int numWords;
+};
+
+#endif // STOPSET_H
@@ -0,0 +1,331 @@
+#include "TraceReader.h"
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include "Building.h"
+
+namespace {
+const char BINARY_MAGIC[4] = {'E', 'L', 'V', 'T'};
+const size_t BINARY_HEADER_SIZE = 8;
+
+std::uint64_t readLittleEndian(const char* data, int bytes) {
+    std::uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; i--) {
+        value = (value << 8) | static_cast<unsigned char>(data[i]);
+    }
+    return value;
+}
+
+void writeLittleEndian(char* data, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        data[i] = static_cast<char>(value & 0xff);
+        value >>= 8;
+    }
+}
+
+// Split off the next comma-separated field, trimming spaces
+char* nextField(char*& cursor) {
+    if (!cursor) {
+        return nullptr;
+    }
+    while (*cursor == ' ' || *cursor == '\t') {
+        cursor++;
+    }
+    char* field = cursor;
+    char* comma = std::strchr(cursor, ',');
+    if (comma) {
+        *comma = '\0';
+        cursor = comma + 1;
+    } else {
+        cursor = nullptr;
+    }
+    
+    size_t length = std::strlen(field);
+    while (length > 0 && (field[length - 1] == ' ' || field[length - 1] == '\t' || field[length - 1] == '\r')) {
+        field[--length] = '\0';
+    }
+    return field;
+}
+
+// Whole-field integer; values beyond int are clamped, since they can only
+// be skipped as out of range
+bool parseInt(const char* field, int& value) {
+    char* parseEnd = nullptr;
+    errno = 0;
+    long result = std::strtol(field, &parseEnd, 10);
+    if (parseEnd == field || *parseEnd != '\0') {
+        return false;
+    }
+    if (errno == ERANGE || result > INT_MAX || result < INT_MIN) {
+        result = (result < 0) ? INT_MIN : INT_MAX;
+    }
+    value = static_cast<int>(result);
+    return true;
+}
+}
+
+TraceReader::TraceReader(const std::string& path)
+    : file(std::fopen(path.c_str(), "rb")), format(CSV), buffer(BUFFER_SIZE + 1), begin(0), end(0),
+      endOfFile(false), lineNumber(0), recordsRead(0), recordsSkipped(0) {
+    if (!file) {
+        throw std::runtime_error("Could not open trace file: " + path);
+    }
+    
+    // Binary traces start with a magic number; anything else is read as CSV
+    fill();
+    if (end - begin >= BINARY_HEADER_SIZE && std::memcmp(&buffer[begin], BINARY_MAGIC, 4) == 0) {
+        std::uint32_t version = static_cast<std::uint32_t>(readLittleEndian(&buffer[begin + 4], 4));
+        if (version != BINARY_VERSION) {
+            std::fclose(file);
+            throw std::runtime_error("Unsupported trace version in " + path);
+        }
+        format = BINARY;
+        begin += BINARY_HEADER_SIZE;
+    }
+}
+
+TraceReader::~TraceReader() {
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+bool TraceReader::fill() {
+    if (endOfFile) {
+        return false;
+    }
+    
+    // Move the unconsumed tail to the front and top the buffer up
+    if (begin > 0) {
+        std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+    }
+    
+    size_t bytesRead = std::fread(buffer.data() + end, 1, BUFFER_SIZE - end, file);
+    end += bytesRead;
+    if (bytesRead == 0) {
+        endOfFile = true;
+    }
+    return bytesRead > 0;
+}
+
+bool TraceReader::next(TraceRecord& record) {
+    bool found = (format == BINARY) ? nextBinary(record) : nextCsv(record);
+    if (found) {
+        recordsRead++;
+    }
+    return found;
+}
+
+bool TraceReader::nextBinary(TraceRecord& record) {
+    if (end - begin < BINARY_RECORD_SIZE) {
+        fill();
+        if (end - begin < BINARY_RECORD_SIZE) {
+            if (end != begin) {
+                throw std::runtime_error("Truncated record at the end of the trace");
+            }
+            return false;
+        }
+    }
+    
+    const char* data = &buffer[begin];
+    begin += BINARY_RECORD_SIZE;
+    
+    record.time = static_cast<SimTime>(readLittleEndian(data, 8));
+    record.type = (data[8] == 1) ? TraceRecord::CAR_CALL : TraceRecord::HALL_CALL;
+    switch (data[9]) {
+        case 0:  record.direction = Request::UP; break;
+        case 1:  record.direction = Request::DOWN; break;
+        default: record.direction = Request::NONE; break;
+    }
+    record.elevator = static_cast<int>(readLittleEndian(data + 10, 2));
+    record.floor = static_cast<std::int32_t>(readLittleEndian(data + 12, 4));
+    return true;
+}
+
+bool TraceReader::nextCsv(TraceRecord& record) {
+    while (true) {
+        // Find the end of the next line, reading more of the file if needed
+        char* start = buffer.data() + begin;
+        char* newline = static_cast<char*>(std::memchr(start, '\n', end - begin));
+        if (!newline) {
+            if (!endOfFile && end - begin == BUFFER_SIZE) {
+                throw std::runtime_error("Trace line " + std::to_string(lineNumber + 1) + " is too long");
+            }
+            if (fill()) {
+                continue;
+            }
+            if (begin == end) {
+                return false;
+            }
+            
+            // Last line without a trailing newline; the byte past
+            // BUFFER_SIZE is kept free for its terminator
+            newline = buffer.data() + end;
+            start = buffer.data() + begin;
+            end++;
+        }
+        
+        *newline = '\0';
+        begin = newline - buffer.data() + 1;
+        lineNumber++;
+        
+        if (parseCsvLine(start, record)) {
+            return true;
+        }
+    }
+}
+
+bool TraceReader::parseCsvLine(char* line, TraceRecord& record) {
+    char* cursor = line;
+    char* timeField = nextField(cursor);
+    if (!timeField || timeField[0] == '\0' || timeField[0] == '#') {
+        return false;
+    }
+    
+    char* parseEnd = nullptr;
+    double seconds = std::strtod(timeField, &parseEnd);
+    if (parseEnd == timeField) {
+        // A non-numeric first line is a header
+        if (lineNumber == 1) {
+            return false;
+        }
+        throw std::runtime_error("Bad time on trace line " + std::to_string(lineNumber));
+    }
+    
+    char* typeField = nextField(cursor);
+    char* floorField = nextField(cursor);
+    char* lastField = nextField(cursor);
+    if (!typeField || !floorField || !lastField) {
+        throw std::runtime_error("Expected 4 fields on trace line " + std::to_string(lineNumber));
+    }
+    
+    record.time = SimClock::fromSeconds(seconds);
+    if (!parseInt(floorField, record.floor)) {
+        throw std::runtime_error("Bad floor on trace line " + std::to_string(lineNumber));
+    }
+    record.direction = Request::NONE;
+    record.elevator = 0;
+    
+    if (std::strcmp(typeField, "hall") == 0) {
+        record.type = TraceRecord::HALL_CALL;
+        if (std::strcmp(lastField, "up") == 0) {
+            record.direction = Request::UP;
+        } else if (std::strcmp(lastField, "down") == 0) {
+            record.direction = Request::DOWN;
+        } else {
+            throw std::runtime_error("Bad direction on trace line " + std::to_string(lineNumber));
+        }
+    } else if (std::strcmp(typeField, "car") == 0) {
+        record.type = TraceRecord::CAR_CALL;
+        if (!parseInt(lastField, record.elevator)) {
+            throw std::runtime_error("Bad elevator on trace line " + std::to_string(lineNumber));
+        }
+    } else {
+        throw std::runtime_error("Bad call type on trace line " + std::to_string(lineNumber));
+    }
+    return true;
+}
+
+long TraceReader::replay(Building& building) {
+    long replayed = 0;
+    TraceRecord record;
+    while (next(record)) {
+        bool valid = record.floor >= 1 && record.floor <= building.getNumFloors() &&
+                     (record.type == TraceRecord::HALL_CALL ||
+                      (record.elevator >= 0 && record.elevator < building.getNumElevators()));
+        if (!valid) {
+            recordsSkipped++;
+            continue;
+        }
+        
+        // Bring the building up to the recorded time; records that are out
+        // of order are injected immediately
+        building.runUntil(record.time);
+        if (record.type == TraceRecord::HALL_CALL) {
+            building.addRequest(Request(record.floor, record.direction));
+        } else {
+            building.addCarCall(record.elevator, record.floor);
+        }
+        replayed++;
+    }
+    return replayed;
+}
+
+TraceReader::Format TraceReader::getFormat() const {
+    return format;
+}
+
+long TraceReader::getRecordsRead() const {
+    return recordsRead;
+}
+
+long TraceReader::getRecordsSkipped() const {
+    return recordsSkipped;
+}
+
+TraceWriter::TraceWriter(const std::string& path)
+    : file(std::fopen(path.c_str(), "wb")), buffer(TraceReader::BUFFER_SIZE), used(0) {
+    if (!file) {
+        throw std::runtime_error("Could not create trace file: " + path);
+    }
+    
+    std::memcpy(buffer.data(), BINARY_MAGIC, 4);
+    writeLittleEndian(buffer.data() + 4, TraceReader::BINARY_VERSION, 4);
+    used = BINARY_HEADER_SIZE;
+}
+
+TraceWriter::~TraceWriter() {
+    if (!file) {
+        return;
+    }
+    
+    // Best effort: a destructor must not throw
+    if (used > 0) {
+        std::fwrite(buffer.data(), 1, used, file);
+    }
+    std::fclose(file);
+}
+
+void TraceWriter::write(const TraceRecord& record) {
+    if (!file) {
+        throw std::logic_error("Trace file is already closed");
+    }
+    if (used + TraceReader::BINARY_RECORD_SIZE > buffer.size()) {
+        flush();
+    }
+    
+    char* data = buffer.data() + used;
+    writeLittleEndian(data, static_cast<std::uint64_t>(record.time), 8);
+    data[8] = (record.type == TraceRecord::CAR_CALL) ? 1 : 0;
+    data[9] = (record.direction == Request::UP) ? 0 : (record.direction == Request::DOWN) ? 1 : 2;
+    writeLittleEndian(data + 10, static_cast<std::uint64_t>(record.elevator), 2);
+    writeLittleEndian(data + 12, static_cast<std::uint32_t>(record.floor), 4);
+    used += TraceReader::BINARY_RECORD_SIZE;
+}
+
+void TraceWriter::flush() {
+    if (!file) {
+        return;
+    }
+    if (used > 0 && std::fwrite(buffer.data(), 1, used, file) != used) {
+        throw std::runtime_error("Failed to write trace file");
+    }
+    used = 0;
+}
+
+void TraceWriter::close() {
+    if (!file) {
+        return;
+    }
+    
+    flush();
+    std::FILE* closing = file;
+    file = nullptr;
+    if (std::fclose(closing) != 0) {
+        throw std::runtime_error("Failed to write trace file");
+    }
+}
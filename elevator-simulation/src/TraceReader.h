@@ -0,0 +1,99 @@
+#ifndef TRACEREADER_H
+#define TRACEREADER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Request.h"
+#include "SimClock.h"
+
+class Building;
+
+// One recorded call from a controller log
+struct TraceRecord {
+    enum Type { HALL_CALL, CAR_CALL };
+    
+    SimTime time;
+    Type type;
+    int floor;
+    Request::Direction direction;   // Hall calls only
+    int elevator;                   // Car calls only, 0-based
+};
+
+// Streams call records from a trace file through a fixed-size buffer, so
+// memory use does not depend on the length of the trace.
+//
+// CSV format, one call per line (a header line and '#' comments are skipped):
+//   <seconds>,hall,<floor>,<up|down>
+//   <seconds>,car,<floor>,<elevator>
+//
+// Binary format: the magic "ELVT", a little-endian uint32 version, then
+// 16-byte little-endian records:
+//   int64 time (microseconds), uint8 type, uint8 direction, uint16 elevator, int32 floor
+class TraceReader {
+public:
+    enum Format { CSV, BINARY };
+    
+    static const size_t BUFFER_SIZE = 64 * 1024;
+    static const size_t BINARY_RECORD_SIZE = 16;
+    static const std::uint32_t BINARY_VERSION = 1;
+    
+    explicit TraceReader(const std::string& path);
+    ~TraceReader();
+    
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+    
+    // Read the next record; returns false at the end of the trace
+    bool next(TraceRecord& record);
+    
+    // Inject every call into the building at its recorded time and return
+    // the number of calls replayed
+    long replay(Building& building);
+    
+    Format getFormat() const;
+    long getRecordsRead() const;
+    long getRecordsSkipped() const;  // Calls the building could not accept
+    
+private:
+    std::FILE* file;
+    Format format;
+    std::vector<char> buffer; // BUFFER_SIZE bytes of data, then room for a terminator
+    size_t begin;   // Unconsumed data is buffer[begin, end)
+    size_t end;
+    bool endOfFile;
+    long lineNumber;
+    long recordsRead;
+    long recordsSkipped;
+    
+    bool fill();
+    bool nextCsv(TraceRecord& record);
+    bool nextBinary(TraceRecord& record);
+    bool parseCsvLine(char* line, TraceRecord& record);
+};
+
+// Writes records in the binary trace format through a fixed-size buffer
+class TraceWriter {
+public:
+    explicit TraceWriter(const std::string& path);
+    ~TraceWriter();
+    
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+    
+    void write(const TraceRecord& record);
+    void flush();
+    
+    // Write out everything and close the file, throwing if any of it could
+    // not be written. The destructor closes a writer that was not closed
+    // but cannot report a failure.
+    void close();
+    
+private:
+    std::FILE* file; // Null once closed
+    std::vector<char> buffer;
+    size_t used;
+};
+
+#endif // TRACEREADER_H
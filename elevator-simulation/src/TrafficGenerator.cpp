@@ -0,0 +1,234 @@
+#include "TrafficGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include "Building.h"
+
+namespace {
+// Share of trips in each direction for the preset patterns
+struct PatternMix {
+    double fromLobby;   // Lobby to upper floors
+    double toLobby;     // Upper floors to lobby
+    double interfloor;  // Between any two floors
+};
+
+PatternMix mixFor(TrafficGenerator::Pattern pattern) {
+    switch (pattern) {
+        case TrafficGenerator::UP_PEAK:   return {0.85, 0.05, 0.10};
+        case TrafficGenerator::DOWN_PEAK: return {0.05, 0.85, 0.10};
+        case TrafficGenerator::LUNCH:     return {0.40, 0.40, 0.20};
+        default:                          return {0.0, 0.0, 1.0};
+    }
+}
+}
+
+TrafficGenerator::TrafficGenerator(int numFloors, double passengersPerHour, std::uint64_t seed)
+    : numFloors(numFloors), ratePerSecond(passengersPerHour / 3600.0), rng(seed), lastArrival(0),
+      hasPending(false) {
+    if (numFloors < 2) {
+        throw std::invalid_argument("Traffic needs at least 2 floors");
+    }
+    if (!(passengersPerHour > 0.0)) {
+        throw std::invalid_argument("Passenger rate must be positive");
+    }
+    setPattern(INTERFLOOR);
+}
+
+void TrafficGenerator::setPattern(Pattern pattern) {
+    PatternMix mix = mixFor(pattern);
+    int upperFloors = numFloors - 1;
+    
+    // Floor 1 is the lobby
+    std::vector<double> weights(numFloors * numFloors, 0.0);
+    for (int origin = 1; origin <= numFloors; origin++) {
+        for (int destination = 1; destination <= numFloors; destination++) {
+            if (origin == destination) {
+                continue;
+            }
+            double weight = mix.interfloor / (numFloors * (numFloors - 1));
+            if (origin == 1) {
+                weight += mix.fromLobby / upperFloors;
+            }
+            if (destination == 1) {
+                weight += mix.toLobby / upperFloors;
+            }
+            weights[(origin - 1) * numFloors + (destination - 1)] = weight;
+        }
+    }
+    setOriginDestinationMatrix(weights);
+}
+
+void TrafficGenerator::setOriginDestinationMatrix(const std::vector<double>& weights) {
+    if (weights.size() != static_cast<size_t>(numFloors) * numFloors) {
+        throw std::invalid_argument("Origin/destination matrix must be " + std::to_string(numFloors) +
+                                    "x" + std::to_string(numFloors));
+    }
+    
+    std::vector<double> cumulative(weights.size());
+    double total = 0.0;
+    for (size_t i = 0; i < weights.size(); i++) {
+        if (weights[i] < 0.0 || !std::isfinite(weights[i])) {
+            throw std::invalid_argument("Origin/destination weights must be finite and non-negative");
+        }
+        // Trips that start and end on the same floor are ignored
+        if (i / numFloors != i % numFloors) {
+            total += weights[i];
+        }
+        cumulative[i] = total;
+    }
+    
+    if (total <= 0.0) {
+        throw std::invalid_argument("Origin/destination matrix has no trips");
+    }
+    cumulativeWeights.swap(cumulative);
+}
+
+void TrafficGenerator::loadOriginDestinationMatrix(const std::string& path) {
+    setOriginDestinationMatrix(readOriginDestinationMatrix(path));
+}
+
+std::vector<double> TrafficGenerator::readOriginDestinationMatrix(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Could not open origin/destination matrix: " + path);
+    }
+    
+    // One row per origin floor, comma or whitespace separated weights
+    std::vector<double> weights;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream row(line);
+        double weight;
+        while (row >> weight) {
+            weights.push_back(weight);
+        }
+    }
+    return weights;
+}
+
+TrafficGenerator::Trip TrafficGenerator::next() {
+    Trip trip;
+    
+    // Exponential inter-arrival times give a Poisson arrival process
+    double gap = -std::log(1.0 - uniform()) / ratePerSecond;
+    lastArrival += std::max<SimTime>(1, SimClock::fromSeconds(gap));
+    trip.time = lastArrival;
+    
+    // Pick an origin/destination pair in proportion to its weight
+    double target = uniform() * cumulativeWeights.back();
+    size_t index = std::upper_bound(cumulativeWeights.begin(), cumulativeWeights.end(), target)
+                   - cumulativeWeights.begin();
+    index = std::min(index, cumulativeWeights.size() - 1);
+    trip.origin = static_cast<int>(index / numFloors) + 1;
+    trip.destination = static_cast<int>(index % numFloors) + 1;
+    return trip;
+}
+
+int TrafficGenerator::run(Building& building, SimTime endTime) {
+    int count = 0;
+    while (true) {
+        Trip trip = hasPending ? pending : next();
+        hasPending = false;
+        if (trip.time > endTime) {
+            pending = trip;
+            hasPending = true;
+            break;
+        }
+        // Let the building catch up to the arrival before adding the passenger
+        building.runUntil(trip.time);
+        building.addPassenger(trip.origin, trip.destination);
+        count++;
+    }
+    building.runUntil(endTime);
+    return count;
+}
+
+void TrafficGenerator::reseed(std::uint64_t seed) {
+    rng.seed(seed);
+    hasPending = false;
+}
+
+void TrafficGenerator::save(BinaryWriter& out) const {
+    out.writeInt(numFloors);
+    out.writeDouble(ratePerSecond);
+    out.writeInt64(lastArrival);
+    out.writeBool(hasPending);
+    out.writeInt64(pending.time);
+    out.writeInt(pending.origin);
+    out.writeInt(pending.destination);
+    out.writeUInt64(cumulativeWeights.size());
+    for (double weight : cumulativeWeights) {
+        out.writeDouble(weight);
+    }
+    
+    // The standard text form is the only portable way to save the engine
+    std::ostringstream engine;
+    engine << rng;
+    out.writeString(engine.str());
+}
+
+std::unique_ptr<TrafficGenerator> TrafficGenerator::restore(BinaryReader& in, int numFloors) {
+    int floors = in.readInt();
+    double rate = in.readDouble();
+    if (floors != numFloors || !(rate > 0.0)) {
+        throw std::runtime_error("Snapshot is corrupt: traffic does not match the building");
+    }
+    std::unique_ptr<TrafficGenerator> traffic(new TrafficGenerator(floors, rate * 3600.0, 0));
+    traffic->ratePerSecond = rate;
+    traffic->lastArrival = in.readInt64();
+    traffic->hasPending = in.readBool();
+    traffic->pending.time = in.readInt64();
+    traffic->pending.origin = in.readInt();
+    traffic->pending.destination = in.readInt();
+    if (traffic->hasPending && (traffic->pending.origin < 1 || traffic->pending.origin > floors ||
+                                traffic->pending.destination < 1 || traffic->pending.destination > floors)) {
+        throw std::runtime_error("Snapshot is corrupt: pending arrival outside the building");
+    }
+    
+    std::vector<double> weights(in.readCount(static_cast<size_t>(floors) * floors));
+    for (double& weight : weights) {
+        weight = in.readDouble();
+    }
+    if (weights.size() != static_cast<size_t>(floors) * floors) {
+        throw std::runtime_error("Snapshot is corrupt: traffic matrix has the wrong size");
+    }
+    traffic->cumulativeWeights.swap(weights);
+    
+    std::istringstream engine(in.readString());
+    engine >> traffic->rng;
+    if (!engine) {
+        throw std::runtime_error("Snapshot is corrupt: bad random generator state");
+    }
+    return traffic;
+}
+
+bool TrafficGenerator::parsePattern(const std::string& name, Pattern& pattern) {
+    if (name == "interfloor") {
+        pattern = INTERFLOOR;
+    } else if (name == "up-peak") {
+        pattern = UP_PEAK;
+    } else if (name == "down-peak") {
+        pattern = DOWN_PEAK;
+    } else if (name == "lunch") {
+        pattern = LUNCH;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* TrafficGenerator::getPatternNames() {
+    return "interfloor, up-peak, down-peak, lunch";
+}
+
+double TrafficGenerator::uniform() {
+    // 53 random bits mapped to [0, 1); unlike std::uniform_real_distribution
+    // this gives the same sequence with every standard library
+    return (rng() >> 11) * (1.0 / 9007199254740992.0);
+}
@@ -0,0 +1,69 @@
+#ifndef TRAFFICGENERATOR_H
+#define TRAFFICGENERATOR_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <memory>
+#include <vector>
+#include "BinaryStream.h"
+#include "SimClock.h"
+
+class Building;
+
+// Seeded passenger source. Arrivals form a Poisson process with a fixed
+// rate, and each trip's origin and destination are drawn from an
+// origin/destination weight matrix. The same seed and settings always
+// produce the same trips.
+class TrafficGenerator {
+public:
+    enum Pattern { INTERFLOOR, UP_PEAK, DOWN_PEAK, LUNCH };
+    
+    TrafficGenerator(int numFloors, double passengersPerHour, std::uint64_t seed);
+    
+    // Replace the origin/destination matrix with a preset pattern
+    void setPattern(Pattern pattern);
+    
+    // Row-major numFloors x numFloors weights; entry [o * numFloors + d] is
+    // the relative frequency of trips from floor o+1 to floor d+1
+    void setOriginDestinationMatrix(const std::vector<double>& weights);
+    void loadOriginDestinationMatrix(const std::string& path);
+    static std::vector<double> readOriginDestinationMatrix(const std::string& path);
+    
+    // Draw the next trip; arrival times are strictly increasing
+    struct Trip {
+        SimTime time;
+        int origin;
+        int destination;
+    };
+    Trip next();
+    
+    // Feed trips into the building on its simulated clock until endTime.
+    // A later call carries on where the previous one stopped, so a long
+    // run can be fed in slices.
+    int run(Building& building, SimTime endTime);
+    
+    // Restart the random stream, keeping the rate, matrix and last arrival
+    void reseed(std::uint64_t seed);
+    
+    // Checkpointing, including the random generator state; a restored
+    // generator must feed a building of numFloors
+    void save(BinaryWriter& out) const;
+    static std::unique_ptr<TrafficGenerator> restore(BinaryReader& in, int numFloors);
+    
+    static bool parsePattern(const std::string& name, Pattern& pattern);
+    static const char* getPatternNames();
+    
+private:
+    int numFloors;
+    double ratePerSecond;
+    std::mt19937_64 rng;
+    SimTime lastArrival;
+    bool hasPending;                       // A trip drawn by run() beyond its end time
+    Trip pending;
+    std::vector<double> cumulativeWeights; // Prefix sums of the OD matrix
+    
+    double uniform();
+};
+
+#endif // TRAFFICGENERATOR_H
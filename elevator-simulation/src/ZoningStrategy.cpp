@@ -0,0 +1,30 @@
+#include "ZoningStrategy.h"
+#include <cstdlib>
+
+const char* ZoningStrategy::getName() const {
+    return "zoning";
+}
+
+int ZoningStrategy::zoneOf(int floor, int numFloors, int numZones) {
+    // Floors above the lobby are spread as evenly as possible across the
+    // zones; the lobby is in all of them
+    if (floor <= LOBBY) {
+        return ALL_ZONES;
+    }
+    return (floor - LOBBY - 1) * numZones / (numFloors - LOBBY);
+}
+
+double ZoningStrategy::cost(const Request& request, const Elevator& elevator,
+                            int numFloors, int numElevators) const {
+    int numZones = (numElevators < numFloors - LOBBY) ? numElevators : numFloors - LOBBY;
+    int callZone = zoneOf(request.getFloor(), numFloors, numZones);
+    int carZone = elevator.getId() % numZones;
+    
+    double distance = std::abs(elevator.getCurrentFloor() - request.getFloor());
+    if (callZone == ALL_ZONES || carZone == callZone) {
+        return distance;
+    }
+    
+    // Out-of-zone cars rank behind every in-zone car
+    return distance + numFloors + 1;
+}
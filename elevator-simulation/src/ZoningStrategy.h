@@ -0,0 +1,25 @@
+#ifndef ZONINGSTRATEGY_H
+#define ZONINGSTRATEGY_H
+
+#include "DispatchStrategy.h"
+
+// Splits the floors above the lobby into one contiguous band per car. Calls
+// go to the nearest car that owns the call's zone; cars from other zones
+// only help out when the zone's car cannot take the call. Every car serves
+// the lobby, where most trips start or end.
+class ZoningStrategy : public DispatchStrategy {
+public:
+    const char* getName() const override;
+    
+    static const int LOBBY = 1;
+    static const int ALL_ZONES = -1;
+    
+    // Zone (0-based) that a floor belongs to; ALL_ZONES for the lobby
+    static int zoneOf(int floor, int numFloors, int numZones);
+    
+protected:
+    double cost(const Request& request, const Elevator& elevator,
+                int numFloors, int numElevators) const override;
+};
+
+#endif // ZONINGSTRATEGY_H
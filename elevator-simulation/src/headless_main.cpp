@@ -0,0 +1,538 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include "Building.h"
+#include "Campus.h"
+#include "Checkpoint.h"
+#include "DispatchStrategy.h"
+#include "EventTrace.h"
+#include "LatencyStats.h"
+#include "MetricsSampler.h"
+#include "MonteCarloRunner.h"
+#include "SimulationConfig.h"
+#include "TraceReader.h"
+#include "TrafficGenerator.h"
+
+// Headless driver: runs a seeded scenario to completion without any
+// window or audio device and prints run metrics.
+
+void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " [options]" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  -c, --config <file>     Load settings from a config file; other options override it" << std::endl;
+    std::cout << "  -e, --elevators <num>   Set number of elevators (default: 4)" << std::endl;
+    std::cout << "  -f, --floors <num>      Set number of floors (default: 10)" << std::endl;
+    std::cout << "  -k, --capacity <num>    Passengers per car (default: 5)" << std::endl;
+    std::cout << "  -t, --traffic <name>    Traffic pattern (default: interfloor)" << std::endl;
+    std::cout << "                          " << TrafficGenerator::getPatternNames() << std::endl;
+    std::cout << "  -m, --od-matrix <file>  Origin/destination weight matrix, one row per origin floor" << std::endl;
+    std::cout << "  -r, --rate <num>        Passenger arrivals per hour (default: 200)" << std::endl;
+    std::cout << "  -d, --duration <sec>    Simulated seconds over which passengers arrive (default: 3600)" << std::endl;
+    std::cout << "  -a, --strategy <name>   Dispatch strategy (default: nearest)" << std::endl;
+    std::cout << "                          " << DispatchStrategy::getAvailableNames() << std::endl;
+    std::cout << "  -s, --seed <num>        Random seed (default: 1)" << std::endl;
+    std::cout << "  -w, --energy-weight <s> Seconds of waiting worth one kWh in the dispatch cost (default: 0)" << std::endl;
+    std::cout << "  -D, --destination-dispatch  Passengers key in destinations and calls are assigned in batches" << std::endl;
+    std::cout << "  --batch-window <sec>    Batching window for destination dispatch; implies -D (default: 2)" << std::endl;
+    std::cout << "  -n, --runs <num>        Repeat the scenario with consecutive seeds and merge the results (default: 1)" << std::endl;
+    std::cout << "  -j, --threads <num>     Worker threads for repeated runs (default: all cores)" << std::endl;
+    std::cout << "  --trace <file>          Replay a recorded call trace (CSV or binary) instead of generating traffic" << std::endl;
+    std::cout << "  --save-state <file>     Save a snapshot of the whole simulation at --save-at" << std::endl;
+    std::cout << "  --save-at <sec>         Simulated time of the snapshot (default: end of arrivals)" << std::endl;
+    std::cout << "  --load-state <file>     Resume from a snapshot; -a, -w, -D and -s override its strategy,"
+              << std::endl;
+    std::cout << "                          dispatch mode and traffic seed." << std::endl;
+    std::cout << "                          With -n, every run forks from the snapshot with its own seed" << std::endl;
+    std::cout << "  --campus <file>         Simulate a campus of towers and banks described in the file" << std::endl;
+    std::cout << "                          (uses -d, -s, -a and -j; the layout sets sizes and traffic)" << std::endl;
+    std::cout << "  --timeline <file>       Record what every call and car did and write it as Chrome trace JSON" << std::endl;
+    std::cout << "  --timeline-size <num>   Events kept for the timeline; older ones are dropped (default: "
+              << EventTrace::DEFAULT_CAPACITY << ")" << std::endl;
+    std::cout << "  --metrics <file>        Write sampled metrics as CSV (.csv) or columnar binary (other names)" << std::endl;
+    std::cout << "  --metrics-interval <s>  Simulated seconds between metrics samples (default: "
+              << MetricsSampler::DEFAULT_INTERVAL_SECONDS << ")" << std::endl;
+    std::cout << "  --convert-trace <in> <out>  Convert a trace to the binary format and exit" << std::endl;
+    std::cout << "  -h, --help              Display this help message" << std::endl;
+}
+
+void printLatency(const char* label, const LatencyStats& stats) {
+    std::cout << label << " (s): mean " << stats.mean()
+              << ", p50 " << stats.percentile(50)
+              << ", p95 " << stats.percentile(95)
+              << ", p99 " << stats.percentile(99)
+              << ", max " << stats.max() << std::endl;
+}
+
+void printEnergy(double netKWh, double regeneratedKWh, int runs, long passengersServed) {
+    std::cout << "Energy (kWh): net " << netKWh << ", regenerated " << regeneratedKWh;
+    if (runs > 1) {
+        std::cout << ", per run " << netKWh / runs;
+    }
+    if (passengersServed > 0) {
+        std::cout << ", per passenger " << netKWh * 1000.0 / passengersServed << " Wh";
+    }
+    std::cout << std::endl;
+}
+
+std::string describeDispatch(double batchWindow) {
+    if (batchWindow <= 0.0) {
+        return "";
+    }
+    std::ostringstream text;
+    text << " with destination dispatch (" << batchWindow << " s batches)";
+    return text.str();
+}
+
+// Repeat a scenario over consecutive seeds in parallel and print the merged metrics
+int runMonteCarlo(const Scenario& scenario, int runs, int threads, const std::string& trafficName) {
+    MonteCarloRunner runner(threads);
+    
+    auto wallStart = std::chrono::steady_clock::now();
+    RunMetrics total = runner.run(MonteCarloRunner::seedSweep(scenario, runs));
+    double wallSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - wallStart).count();
+    
+    std::cout << "Floors: " << scenario.numFloors << ", elevators: " << scenario.numElevators
+              << ", capacity: " << scenario.capacity << ", traffic: " << trafficName
+              << ", strategy: " << scenario.strategy << describeDispatch(scenario.batchWindow)
+              << ", seeds: " << scenario.seed << "-" << (scenario.seed + runs - 1) << std::endl;
+    std::cout << "Runs: " << total.runs << ", threads: " << runner.getThreadCount() << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Simulated time: " << total.simulatedSeconds << " s" << std::endl;
+    std::cout << "Wall time: " << wallSeconds << " s" << std::endl;
+    std::cout << "Events processed: " << total.eventsProcessed << std::endl;
+    if (wallSeconds > 0.0) {
+        std::cout << "Speed-up: " << total.simulatedSeconds / wallSeconds << "x" << std::endl;
+    }
+    std::cout << "Total: floors travelled " << total.floorsTravelled << ", stops " << total.stopsServed << std::endl;
+    printEnergy(total.energyKWh, total.regeneratedKWh, total.runs, total.passengersServed);
+    
+    std::cout << "Passengers: " << total.passengers << ", served: " << total.passengersServed << std::endl;
+    printLatency("Wait time", total.waitTimes);
+    printLatency("Ride time", total.rideTimes);
+    
+    // Normal-approximation interval on the mean wait across runs
+    const std::vector<double>& runMeans = total.runMeanWaits;
+    double mean = 0.0;
+    for (double runMean : runMeans) {
+        mean += runMean / runMeans.size();
+    }
+    double squares = 0.0;
+    for (double runMean : runMeans) {
+        squares += (runMean - mean) * (runMean - mean);
+    }
+    double stddev = (runMeans.size() > 1) ? std::sqrt(squares / (runMeans.size() - 1)) : 0.0;
+    double halfWidth = 1.96 * stddev / std::sqrt(static_cast<double>(runMeans.size()));
+    std::cout << "Mean wait per run (s): " << mean << " +/- " << halfWidth
+              << " (95% CI)" << std::endl;
+    return 0;
+}
+
+// "1,21-40" style list of the floors a bank serves
+std::string formatFloors(const std::vector<int>& floors) {
+    std::string text;
+    for (size_t i = 0; i < floors.size(); i++) {
+        size_t last = i;
+        while (last + 1 < floors.size() && floors[last + 1] == floors[last] + 1) {
+            last++;
+        }
+        text += (text.empty() ? "" : ",") + std::to_string(floors[i]);
+        if (last > i) {
+            text += "-" + std::to_string(floors[last]);
+        }
+        i = last;
+    }
+    return text;
+}
+
+// Run every bank of a campus on its own shard and print per-bank and
+// door-to-door journey metrics
+int runCampus(const std::string& path, double duration, std::uint64_t seed, const std::string& strategy,
+              int threads) {
+    Campus campus(Campus::Layout::load(path), seed);
+    campus.setDispatchStrategy(strategy);
+    
+    auto wallStart = std::chrono::steady_clock::now();
+    campus.run(SimClock::fromSeconds(duration), threads);
+    double wallSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - wallStart).count();
+    
+    const Campus::Layout& layout = campus.getLayout();
+    int numElevators = 0;
+    long eventsProcessed = 0;
+    for (int i = 0; i < campus.getNumBanks(); i++) {
+        numElevators += campus.getBank(i).getNumElevators();
+        eventsProcessed += campus.getBank(i).getEventsProcessed();
+    }
+    double simSeconds = SimClock::toSeconds(campus.getTime());
+    std::cout << "Campus: " << path << ", towers: " << layout.towers.size()
+              << ", banks: " << campus.getNumBanks() << ", elevators: " << numElevators
+              << ", strategy: " << strategy << ", seed: " << seed << std::endl;
+    std::cout << "Shards: " << campus.getShardCount() << ", transfer time: " << layout.transferTime << " s" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Simulated time: " << simSeconds << " s" << std::endl;
+    std::cout << "Wall time: " << wallSeconds << " s" << std::endl;
+    std::cout << "Events processed: " << eventsProcessed << std::endl;
+    if (wallSeconds > 0.0) {
+        std::cout << "Speed-up: " << simSeconds / wallSeconds << "x" << std::endl;
+    }
+    
+    for (int i = 0; i < campus.getNumBanks(); i++) {
+        const Campus::Bank& bank = layout.banks[i];
+        const Building& building = campus.getBank(i);
+        std::cout << "Bank " << layout.towers[bank.tower].name << "/" << bank.name
+                  << " (floors " << formatFloors(bank.floors) << ", " << bank.numElevators << " cars)"
+                  << ": served " << building.getPassengersServed()
+                  << ", wait mean " << building.getWaitTimes().mean()
+                  << ", p95 " << building.getWaitTimes().percentile(95) << std::endl;
+    }
+    
+    std::cout << "Journeys: " << campus.getJourneysStarted() << ", completed: " << campus.getJourneysCompleted()
+              << ", transfers: " << campus.getTransfers() << std::endl;
+    printLatency("Journey time", campus.getJourneyTimes());
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        // Settings from a config file become the defaults for the options below
+        SimulationConfig config;
+        for (int i = 1; i + 1 < argc; i++) {
+            if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--config") == 0) {
+                config = SimulationConfig::load(argv[i + 1]);
+            }
+        }
+        
+        int numFloors = config.numFloors;
+        int numElevators = config.numElevators;
+        int capacity = config.elevatorCapacity;
+        std::string trafficName = "interfloor";
+        std::string matrixPath;
+        double rate = 200.0;
+        double duration = 3600.0;
+        std::uint64_t seed = 1;
+        std::string strategyName = config.strategy;
+        std::string tracePath;
+        std::string timelinePath;
+        std::string campusPath;
+        std::string metricsPath;
+        double metricsInterval = MetricsSampler::DEFAULT_INTERVAL_SECONDS;
+        double energyWeight = 0.0;
+        int runs = 1;
+        int threads = 0;
+        std::string saveStatePath;
+        double saveAt = -1.0;
+        std::string loadStatePath;
+        bool strategyGiven = false;
+        bool seedGiven = false;
+        bool energyWeightGiven = false;
+        bool destinationDispatch = false;
+        bool destinationGiven = false;
+        double batchWindow = 2.0;
+        
+        // Parse command-line arguments
+        for (int i = 1; i < argc; i++) {
+            bool hasValue = i + 1 < argc;
+            if ((strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--config") == 0) && hasValue) {
+                i++; // Already loaded above
+            } else if ((strcmp(argv[i], "-e") == 0 || strcmp(argv[i], "--elevators") == 0) && hasValue) {
+                numElevators = std::stoi(argv[++i]);
+            } else if ((strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--floors") == 0) && hasValue) {
+                numFloors = std::stoi(argv[++i]);
+            } else if ((strcmp(argv[i], "-k") == 0 || strcmp(argv[i], "--capacity") == 0) && hasValue) {
+                capacity = std::stoi(argv[++i]);
+            } else if ((strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--traffic") == 0) && hasValue) {
+                trafficName = argv[++i];
+            } else if ((strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--od-matrix") == 0) && hasValue) {
+                matrixPath = argv[++i];
+            } else if ((strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--rate") == 0) && hasValue) {
+                rate = std::stod(argv[++i]);
+            } else if ((strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--duration") == 0) && hasValue) {
+                duration = std::stod(argv[++i]);
+            } else if ((strcmp(argv[i], "-a") == 0 || strcmp(argv[i], "--strategy") == 0) && hasValue) {
+                strategyName = argv[++i];
+                strategyGiven = true;
+            } else if ((strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--seed") == 0) && hasValue) {
+                seed = std::stoull(argv[++i]);
+                seedGiven = true;
+            } else if ((strcmp(argv[i], "-w") == 0 || strcmp(argv[i], "--energy-weight") == 0) && hasValue) {
+                energyWeight = std::stod(argv[++i]);
+                energyWeightGiven = true;
+            } else if (strcmp(argv[i], "-D") == 0 || strcmp(argv[i], "--destination-dispatch") == 0) {
+                destinationDispatch = true;
+                destinationGiven = true;
+            } else if (strcmp(argv[i], "--batch-window") == 0 && hasValue) {
+                batchWindow = std::stod(argv[++i]);
+                destinationDispatch = true;
+                destinationGiven = true;
+            } else if ((strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--runs") == 0) && hasValue) {
+                runs = std::stoi(argv[++i]);
+            } else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--threads") == 0) && hasValue) {
+                threads = std::stoi(argv[++i]);
+            } else if (strcmp(argv[i], "--trace") == 0 && hasValue) {
+                tracePath = argv[++i];
+            } else if (strcmp(argv[i], "--campus") == 0 && hasValue) {
+                campusPath = argv[++i];
+            } else if (strcmp(argv[i], "--timeline") == 0 && hasValue) {
+                timelinePath = argv[++i];
+            } else if (strcmp(argv[i], "--timeline-size") == 0 && hasValue) {
+                EventTrace::setCapacity(std::stoul(argv[++i]));
+            } else if (strcmp(argv[i], "--metrics") == 0 && hasValue) {
+                metricsPath = argv[++i];
+            } else if (strcmp(argv[i], "--metrics-interval") == 0 && hasValue) {
+                metricsInterval = std::stod(argv[++i]);
+            } else if (strcmp(argv[i], "--save-state") == 0 && hasValue) {
+                saveStatePath = argv[++i];
+            } else if (strcmp(argv[i], "--save-at") == 0 && hasValue) {
+                saveAt = std::stod(argv[++i]);
+            } else if (strcmp(argv[i], "--load-state") == 0 && hasValue) {
+                loadStatePath = argv[++i];
+            } else if (strcmp(argv[i], "--convert-trace") == 0 && i + 2 < argc) {
+                TraceReader reader(argv[i + 1]);
+                TraceWriter writer(argv[i + 2]);
+                TraceRecord record;
+                while (reader.next(record)) {
+                    writer.write(record);
+                }
+                writer.close();
+                std::cout << "Converted " << reader.getRecordsRead() << " records to " << argv[i + 2] << std::endl;
+                return 0;
+            } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+                printUsage(argv[0]);
+                return 0;
+            } else {
+                std::cerr << "Unknown option: " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        
+        if (numFloors < 2 || numElevators < 1 || capacity < 1 || rate <= 0.0 || duration <= 0.0 || energyWeight < 0.0 ||
+            batchWindow <= 0.0 || metricsInterval <= 0.0 || runs < 1 || threads < 0 || (runs > 1 && !tracePath.empty()) ||
+            (!tracePath.empty() && (!saveStatePath.empty() || !loadStatePath.empty() || destinationDispatch)) ||
+            (runs > 1 && (!saveStatePath.empty() || !timelinePath.empty() || !metricsPath.empty())) ||
+            (!campusPath.empty() && (runs > 1 || !tracePath.empty() || !timelinePath.empty() || !metricsPath.empty() ||
+                                     destinationDispatch ||
+                                     !saveStatePath.empty() || !loadStatePath.empty()))) {
+            std::cerr << "Invalid scenario parameters" << std::endl;
+            return 1;
+        }
+        if (!campusPath.empty()) {
+            return runCampus(campusPath, duration, seed, strategyName, threads);
+        }
+        if (!timelinePath.empty() && !EventTrace::isCompiledIn()) {
+            std::cerr << "This build has no event tracing; configure with -DELEVATOR_TRACING=ON" << std::endl;
+            return 1;
+        }
+        
+        TrafficGenerator::Pattern pattern;
+        if (!TrafficGenerator::parsePattern(trafficName, pattern)) {
+            std::cerr << "Unknown traffic pattern: " << trafficName << std::endl;
+            return 1;
+        }
+        
+        // A snapshot fixes the building; only the options given explicitly
+        // change what happens from there on
+        std::unique_ptr<Checkpoint> loaded;
+        std::shared_ptr<const std::string> snapshotBytes;
+        if (!loadStatePath.empty()) {
+            std::ifstream file(loadStatePath, std::ios::binary);
+            if (!file) {
+                std::cerr << "Could not open snapshot file: " << loadStatePath << std::endl;
+                return 1;
+            }
+            snapshotBytes = std::make_shared<const std::string>(std::istreambuf_iterator<char>(file),
+                                                                std::istreambuf_iterator<char>());
+            loaded.reset(new Checkpoint(Checkpoint::fromBytes(*snapshotBytes)));
+            
+            const Building& saved = *loaded->building;
+            numFloors = saved.getNumFloors();
+            numElevators = saved.getNumElevators();
+            capacity = saved.getFleet().capacity[0];
+            if (!strategyGiven) {
+                strategyName = saved.getDispatchStrategy().getName();
+            }
+            if (!energyWeightGiven) {
+                energyWeight = saved.getDispatchStrategy().getEnergyWeight();
+            }
+            if (!destinationGiven && saved.getDestinationBatchWindow() > 0) {
+                destinationDispatch = true;
+                batchWindow = SimClock::toSeconds(saved.getDestinationBatchWindow());
+            }
+            trafficName = loadStatePath;
+        }
+        
+        std::unique_ptr<DispatchStrategy> strategy = DispatchStrategy::create(strategyName);
+        if (!strategy) {
+            std::cerr << "Unknown dispatch strategy: " << strategyName << std::endl;
+            return 1;
+        }
+        
+        if (runs > 1) {
+            Scenario scenario;
+            scenario.numFloors = numFloors;
+            scenario.numElevators = numElevators;
+            scenario.capacity = capacity;
+            scenario.pattern = pattern;
+            scenario.passengersPerHour = rate;
+            scenario.duration = duration;
+            scenario.strategy = strategyName;
+            scenario.seed = seed;
+            scenario.energyWeight = energyWeight;
+            scenario.batchWindow = destinationDispatch ? batchWindow : 0.0;
+            scenario.checkpoint = snapshotBytes;
+            for (int i = 0; i < numElevators; i++) {
+                scenario.carParams.push_back(config.carParams(i));
+            }
+            if (!matrixPath.empty()) {
+                scenario.originDestination = TrafficGenerator::readOriginDestinationMatrix(matrixPath);
+                trafficName = matrixPath;
+            }
+            return runMonteCarlo(scenario, runs, threads, trafficName);
+        }
+        
+        std::unique_ptr<Building> buildingOwner;
+        std::unique_ptr<TrafficGenerator> traffic;
+        if (loaded) {
+            buildingOwner = std::move(loaded->building);
+            traffic = std::move(loaded->traffic);
+            if (traffic && seedGiven) {
+                traffic->reseed(seed);
+            }
+        } else {
+            buildingOwner.reset(new Building(numFloors, numElevators, capacity));
+            for (int i = 0; i < numElevators; i++) {
+                buildingOwner->setCarParams(i, config.carParams(i));
+            }
+            
+            traffic.reset(new TrafficGenerator(numFloors, rate, seed));
+            if (matrixPath.empty()) {
+                traffic->setPattern(pattern);
+            } else {
+                traffic->loadOriginDestinationMatrix(matrixPath);
+                trafficName = matrixPath;
+            }
+        }
+        Building& building = *buildingOwner;
+        strategy->setEnergyWeight(energyWeight);
+        building.setDispatchStrategy(std::move(strategy));
+        building.setDestinationDispatch(destinationDispatch ? SimClock::fromSeconds(batchWindow) : 0);
+        
+        EventTrace::setEnabled(!timelinePath.empty());
+        
+        std::unique_ptr<MetricsSampler> metrics;
+        if (!metricsPath.empty()) {
+            metrics.reset(new MetricsSampler(SimClock::fromSeconds(metricsInterval)));
+            metrics->addSink(MetricsSink::openFile(metricsPath));
+            building.setSampler(metrics.get());
+        }
+        
+        // Feed arrivals on the simulated clock, then let the cars finish
+        auto wallStart = std::chrono::steady_clock::now();
+        long numPassengers = 0;
+        long numCalls = 0;
+        long skippedCalls = 0;
+        if (tracePath.empty()) {
+            SimTime end = SimClock::fromSeconds(duration);
+            if (!saveStatePath.empty()) {
+                SimTime snapshotTime = (saveAt >= 0.0) ? SimClock::fromSeconds(saveAt) : end;
+                if (traffic) {
+                    numPassengers += traffic->run(building, std::min(snapshotTime, end));
+                }
+                building.runUntil(snapshotTime);
+                Checkpoint::saveFile(saveStatePath, building, traffic.get());
+                std::cout << "Saved snapshot at " << SimClock::toSeconds(building.getClock().now())
+                          << " s to " << saveStatePath << std::endl;
+            }
+            if (traffic) {
+                numPassengers += traffic->run(building, end);
+            }
+        } else {
+            TraceReader reader(tracePath);
+            numCalls = reader.replay(building);
+            skippedCalls = reader.getRecordsSkipped();
+            trafficName = tracePath;
+        }
+        while (building.step()) {
+        }
+        double wallSeconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - wallStart).count();
+        
+        // Print metrics
+        double simSeconds = building.getClock().nowSeconds();
+        std::cout << "Floors: " << numFloors << ", elevators: " << numElevators
+                  << ", capacity: " << capacity << ", traffic: " << trafficName
+                  << ", passengers: " << numPassengers
+                  << ", strategy: " << building.getDispatchStrategy().getName()
+                  << describeDispatch(destinationDispatch ? batchWindow : 0.0)
+                  << ", seed: " << ((loaded && !seedGiven) ? "from snapshot" : std::to_string(seed)) << std::endl;
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "Simulated time: " << simSeconds << " s" << std::endl;
+        std::cout << "Wall time: " << wallSeconds << " s" << std::endl;
+        std::cout << "Events processed: " << building.getEventsProcessed() << std::endl;
+        if (wallSeconds > 0.0) {
+            std::cout << "Speed-up: " << simSeconds / wallSeconds << "x" << std::endl;
+        }
+        
+        int totalFloors = 0;
+        int totalStops = 0;
+        double totalEnergy = 0.0;
+        double totalRegenerated = 0.0;
+        for (const auto& elevator : building.getElevators()) {
+            Elevator::EnergyUse energy = elevator.getEnergyUse();
+            std::cout << "Elevator " << (elevator.getId() + 1)
+                      << ": floors travelled " << elevator.getFloorsTravelled()
+                      << ", stops " << elevator.getStopsServed()
+                      << ", energy " << EnergyModel::toKWh(elevator.getNetEnergy()) << " kWh"
+                      << " (motor " << EnergyModel::toKWh(energy.motor)
+                      << ", regenerated " << EnergyModel::toKWh(energy.regenerated)
+                      << ", doors " << EnergyModel::toKWh(energy.doors)
+                      << ", standby " << EnergyModel::toKWh(energy.standby) << ")" << std::endl;
+            totalFloors += elevator.getFloorsTravelled();
+            totalStops += elevator.getStopsServed();
+            totalEnergy += EnergyModel::toKWh(elevator.getNetEnergy());
+            totalRegenerated += EnergyModel::toKWh(energy.regenerated);
+        }
+        std::cout << "Total: floors travelled " << totalFloors << ", stops " << totalStops << std::endl;
+        printEnergy(totalEnergy, totalRegenerated, 1, building.getPassengersServed());
+        
+        if (!tracePath.empty()) {
+            std::cout << "Trace calls replayed: " << numCalls << ", skipped: " << skippedCalls << std::endl;
+        }
+        
+        // Latency distributions
+        std::cout << "Passengers served: " << building.getPassengersServed() << std::endl;
+        printLatency("Wait time", building.getWaitTimes());
+        printLatency("Ride time", building.getRideTimes());
+        
+        if (metrics) {
+            metrics->close();
+            std::cout << "Metrics: " << metrics->getSamplesTaken() << " samples written to " << metricsPath << std::endl;
+        }
+        
+        if (!timelinePath.empty()) {
+            EventTrace::exportChromeTrace(timelinePath);
+            std::cout << "Timeline: " << EventTrace::getRecordCount() << " events written to " << timelinePath;
+            if (EventTrace::getDroppedCount() > 0) {
+                std::cout << ", " << EventTrace::getDroppedCount() << " oldest dropped";
+            }
+            std::cout << std::endl;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
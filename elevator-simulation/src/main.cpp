@@ -1,23 +1,74 @@
 #include <SFML/Graphics.hpp>
+#include <filesystem>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <cstring>
+#include <utility>
 #include "Building.h"
+#include "DispatchStrategy.h"
+#include "EventTrace.h"
 #include "GUI.h"
+#include "MetricsSampler.h"
+#include "MetricsServer.h"
+#include "SimulationConfig.h"
+#include "SimulationThread.h"
+
+const char* const DEFAULT_CONFIG_PATH = "assets/config.txt";
 
 void printUsage(const char* programName) {
     std::cout << "Usage: " << programName << " [options]" << std::endl;
     std::cout << "Options:" << std::endl;
-    std::cout << "  -e, --elevators <num>   Set number of elevators (1-5, default: 4)" << std::endl;
-    std::cout << "  -f, --floors <num>      Set number of floors (2-12, default: 10)" << std::endl;
+    std::cout << "  -e, --elevators <num>   Set number of elevators (" << Building::MIN_ELEVATORS << "-"
+              << Building::MAX_ELEVATORS << ", default: 4)" << std::endl;
+    std::cout << "  -f, --floors <num>      Set number of floors (" << Building::MIN_FLOORS << "-"
+              << Building::MAX_FLOORS << ", default: 10)" << std::endl;
+    std::cout << "  -a, --strategy <name>   Dispatch strategy (default: nearest)" << std::endl;
+    std::cout << "                          " << DispatchStrategy::getAvailableNames() << std::endl;
+    std::cout << "  -x, --speed <factor>    Simulated seconds per wall-clock second (default: 1.0)" << std::endl;
+    std::cout << "  -c, --config <file>     Settings file, watched for changes while running (default: "
+              << DEFAULT_CONFIG_PATH << " if present)" << std::endl;
+    std::cout << "                          Command-line options override the file" << std::endl;
+    std::cout << "  --timeline <file>       On exit, write what every call and car did as Chrome trace JSON" << std::endl;
+    std::cout << "  --metrics <file>        Write sampled metrics as CSV (.csv) or columnar binary (other names)" << std::endl;
+    std::cout << "  --metrics-port <port>   Serve the latest metrics in Prometheus text format on 127.0.0.1" << std::endl;
+    std::cout << "  --metrics-interval <s>  Simulated seconds between metrics samples (default: "
+              << MetricsSampler::DEFAULT_INTERVAL_SECONDS << ")" << std::endl;
     std::cout << "  -h, --help              Display this help message" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
     try {
-        // Default configuration - updated defaults
-        int numFloors = 10;
-        int numElevators = 4;
+        // The config file, if any, provides the defaults for every option
+        std::string configPath;
+        for (int i = 1; i + 1 < argc; i++) {
+            if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--config") == 0) {
+                configPath = argv[i + 1];
+            }
+        }
+        if (configPath.empty() && std::filesystem::exists(DEFAULT_CONFIG_PATH)) {
+            configPath = DEFAULT_CONFIG_PATH;
+        }
+        
+        SimulationConfig config;
+        if (!configPath.empty()) {
+            try {
+                config = SimulationConfig::load(configPath);
+            } catch (const std::exception& e) {
+                std::cerr << "Invalid config: " << e.what() << std::endl;
+                return 1;
+            }
+            std::cout << "Loaded config from " << configPath << std::endl;
+        }
+        
+        int numFloors = config.numFloors;
+        int numElevators = config.numElevators;
+        std::string strategyName = config.strategy;
+        double speed = config.simulationSpeed;
+        std::string timelinePath;
+        std::string metricsPath;
+        int metricsPort = -1;
+        double metricsInterval = MetricsSampler::DEFAULT_INTERVAL_SECONDS;
         
         // Parse command-line arguments
         for (int i = 1; i < argc; i++) {
@@ -25,30 +76,91 @@ int main(int argc, char* argv[]) {
                 if (i + 1 < argc) {
                     try {
                         numElevators = std::stoi(argv[++i]);
-                        // Validate range - updated maximum
-                        if (numElevators < 1 || numElevators > 5) {
-                            std::cerr << "Warning: Number of elevators must be between 1 and 5. Using default (4)." << std::endl;
-                            numElevators = 4;
+                        // Validate range
+                        if (numElevators < Building::MIN_ELEVATORS || numElevators > Building::MAX_ELEVATORS) {
+                            std::cerr << "Warning: Number of elevators must be between " << Building::MIN_ELEVATORS
+                                      << " and " << Building::MAX_ELEVATORS << ". Using default (" << config.numElevators << ")." << std::endl;
+                            numElevators = config.numElevators;
                         }
                     } catch (const std::exception& e) {
-                        std::cerr << "Error parsing elevator count. Using default (4)." << std::endl;
-                        numElevators = 4;
+                        std::cerr << "Error parsing elevator count. Using default (" << config.numElevators << ")." << std::endl;
+                        numElevators = config.numElevators;
                     }
                 }
             } else if (strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--floors") == 0) {
                 if (i + 1 < argc) {
                     try {
                         numFloors = std::stoi(argv[++i]);
-                        // Validate range - updated maximum
-                        if (numFloors < 2 || numFloors > 12) {
-                            std::cerr << "Warning: Number of floors must be between 2 and 12. Using default (10)." << std::endl;
-                            numFloors = 10;
+                        // Validate range
+                        if (numFloors < Building::MIN_FLOORS || numFloors > Building::MAX_FLOORS) {
+                            std::cerr << "Warning: Number of floors must be between " << Building::MIN_FLOORS
+                                      << " and " << Building::MAX_FLOORS << ". Using default (" << config.numFloors << ")." << std::endl;
+                            numFloors = config.numFloors;
+                        }
+                    } catch (const std::exception& e) {
+                        std::cerr << "Error parsing floor count. Using default (" << config.numFloors << ")." << std::endl;
+                        numFloors = config.numFloors;
+                    }
+                }
+            } else if (strcmp(argv[i], "-a") == 0 || strcmp(argv[i], "--strategy") == 0) {
+                if (i + 1 < argc) {
+                    strategyName = argv[++i];
+                }
+            } else if (strcmp(argv[i], "-x") == 0 || strcmp(argv[i], "--speed") == 0) {
+                if (i + 1 < argc) {
+                    try {
+                        speed = std::stod(argv[++i]);
+                        if (speed <= 0.0) {
+                            std::cerr << "Warning: Simulation speed must be positive. Using default (" << config.simulationSpeed << ")." << std::endl;
+                            speed = config.simulationSpeed;
+                        }
+                    } catch (const std::exception& e) {
+                        std::cerr << "Error parsing simulation speed. Using default (" << config.simulationSpeed << ")." << std::endl;
+                        speed = config.simulationSpeed;
+                    }
+                }
+            } else if (strcmp(argv[i], "--timeline") == 0) {
+                if (i + 1 < argc) {
+                    timelinePath = argv[++i];
+                    if (!EventTrace::isCompiledIn()) {
+                        std::cerr << "Warning: This build has no event tracing. No timeline will be written." << std::endl;
+                        timelinePath.clear();
+                    }
+                }
+            } else if (strcmp(argv[i], "--metrics") == 0) {
+                if (i + 1 < argc) {
+                    metricsPath = argv[++i];
+                }
+            } else if (strcmp(argv[i], "--metrics-port") == 0) {
+                if (i + 1 < argc) {
+                    try {
+                        metricsPort = std::stoi(argv[++i]);
+                        if (metricsPort < 0 || metricsPort > 65535) {
+                            std::cerr << "Warning: Metrics port must be between 0 and 65535. Not serving metrics." << std::endl;
+                            metricsPort = -1;
+                        }
+                    } catch (const std::exception& e) {
+                        std::cerr << "Error parsing metrics port. Not serving metrics." << std::endl;
+                        metricsPort = -1;
+                    }
+                }
+            } else if (strcmp(argv[i], "--metrics-interval") == 0) {
+                if (i + 1 < argc) {
+                    try {
+                        metricsInterval = std::stod(argv[++i]);
+                        if (metricsInterval <= 0.0) {
+                            std::cerr << "Warning: Metrics interval must be positive. Using default ("
+                                      << MetricsSampler::DEFAULT_INTERVAL_SECONDS << ")." << std::endl;
+                            metricsInterval = MetricsSampler::DEFAULT_INTERVAL_SECONDS;
                         }
                     } catch (const std::exception& e) {
-                        std::cerr << "Error parsing floor count. Using default (10)." << std::endl;
-                        numFloors = 10;
+                        std::cerr << "Error parsing metrics interval. Using default ("
+                                  << MetricsSampler::DEFAULT_INTERVAL_SECONDS << ")." << std::endl;
+                        metricsInterval = MetricsSampler::DEFAULT_INTERVAL_SECONDS;
                     }
                 }
+            } else if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--config") == 0) {
+                i++; // Already loaded above
             } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
                 printUsage(argv[0]);
                 return 0;
@@ -68,15 +180,49 @@ int main(int argc, char* argv[]) {
         
         // Create building with configurable floors and elevators
         Building building(numFloors, numElevators);
+        config.applyTo(building);
+        
+        // Select the dispatch strategy
+        std::unique_ptr<DispatchStrategy> strategy = DispatchStrategy::create(strategyName);
+        if (!strategy) {
+            std::cerr << "Unknown dispatch strategy: " << strategyName << ". Using default (nearest)." << std::endl;
+        } else {
+            building.setDispatchStrategy(std::move(strategy));
+        }
+        
+        // Metrics are sampled on the simulation thread as simulated time
+        // passes, so the sampler has to outlive it
+        std::unique_ptr<MetricsSampler> metrics;
+        if (!metricsPath.empty() || metricsPort >= 0) {
+            metrics.reset(new MetricsSampler(SimClock::fromSeconds(metricsInterval)));
+            if (!metricsPath.empty()) {
+                metrics->addSink(MetricsSink::openFile(metricsPath));
+            }
+            if (metricsPort >= 0) {
+                std::unique_ptr<MetricsServer> server(new MetricsServer(metricsPort));
+                std::cout << "Serving metrics at http://127.0.0.1:" << server->getPort() << "/metrics" << std::endl;
+                metrics->addSink(std::move(server));
+            }
+            building.setSampler(metrics.get());
+        }
+        
+        // The model advances on its own fixed-step thread; the GUI only sees snapshots
+        SimulationThread simulation(building, speed);
+        if (!configPath.empty()) {
+            simulation.watchConfig(configPath, config);
+        }
         
         // Create and initialize GUI
-        GUI gui(window, building);
+        GUI gui(window, simulation);
         if (!gui.initialize()) {
             std::cerr << "Failed to initialize GUI" << std::endl;
             return 1;
         }
         
-        // Main simulation loop
+        EventTrace::setEnabled(!timelinePath.empty());
+        simulation.start();
+        
+        // Main render loop
         sf::Clock clock;
         while (window.isOpen()) {
             // Calculate delta time
@@ -88,8 +234,12 @@ int main(int argc, char* argv[]) {
                 gui.handleEvent(event);
             }
             
-            // Update simulation
-            building.update();
+            // Report config reloads from the simulation thread
+            std::string configStatus;
+            bool configFailed = false;
+            if (simulation.takeConfigStatus(configStatus, configFailed)) {
+                (configFailed ? std::cerr : std::cout) << configStatus << std::endl;
+            }
             
             // Update GUI
             gui.update(deltaTime.asSeconds());
@@ -97,6 +247,16 @@ int main(int argc, char* argv[]) {
             // Render
             gui.render();
         }
+        
+        simulation.stop();
+        if (metrics) {
+            metrics->close();
+        }
+        
+        if (!timelinePath.empty()) {
+            EventTrace::exportChromeTrace(timelinePath);
+            std::cout << "Timeline written to " << timelinePath << std::endl;
+        }
     }
     catch (const std::exception& e) {
         std::cerr << "Exception: " << e.what() << std::endl;